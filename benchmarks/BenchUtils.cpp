@@ -0,0 +1,94 @@
+#include "BenchUtils.hpp"
+#include "../project/Time.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> g_allocatedBytes{0};
+
+// The default std::pmr resource calls the library's own operator new, which the
+// replacement below does not see; send the pmr containers through it too.
+class HeapResource : public std::pmr::memory_resource {
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, std::align_val_t(alignment));
+        return ::operator new(bytes);
+    }
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(pointer, bytes, std::align_val_t(alignment));
+        else
+            ::operator delete(pointer, bytes);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+HeapResource g_heapResource;
+const bool g_heapResourceInstalled = (std::pmr::set_default_resource(&g_heapResource), true);
+}
+
+// Count every heap allocation of the benchmark binary.
+void *operator new(size_t size) {
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace Bench {
+
+uint64_t allocatedBytes() {
+    return g_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void reportEvents(benchmark::State &state, int64_t events, uint64_t bytesBefore) {
+    int64_t total = events * static_cast<int64_t>(state.iterations());
+    state.SetItemsProcessed(total);
+    state.counters["events/s"] = benchmark::Counter(static_cast<double>(total), benchmark::Counter::kIsRate);
+    state.counters["bytes/event"] = total == 0 ? 0.0 : static_cast<double>(allocatedBytes() - bytesBefore) / total;
+}
+
+std::string syntheticDay(int64_t events, int tables, uint32_t seed) {
+    const int openTime = 9 * 60;
+    const int closeTime = 23 * 60;
+    std::string text = std::to_string(tables) + "\n09:00 23:00\n10\n";
+    text.reserve(text.size() + events * 24);
+    // Clients arrive, sit, sometimes wait and eventually leave; ids are reused
+    // so that the number of clients in the club stays around a few per table.
+    int64_t clientsPool = std::max<int64_t>(4, std::min<int64_t>(events / 4, tables * 4LL));
+    uint64_t state = seed;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<uint32_t>(state >> 33);
+    };
+    char timeText[Yadro::Time::kMaxLength];
+    for (int64_t i = 0; i < events; i++) {
+        int time = openTime + static_cast<int>(i * (closeTime - openTime) / std::max<int64_t>(events, 1));
+        text.append(timeText, Yadro::Time::Format(time, timeText));
+        int64_t client = next() % clientsPool;
+        uint32_t kind = next() % 10;
+        if (kind < 3) {
+            text += " 1 client" + std::to_string(client) + "\n";
+        } else if (kind < 6) {
+            text += " 2 client" + std::to_string(client) + " " + std::to_string(next() % tables + 1) + "\n";
+        } else if (kind < 7) {
+            text += " 3 client" + std::to_string(client) + "\n";
+        } else {
+            text += " 4 client" + std::to_string(client) + "\n";
+        }
+    }
+    return text;
+}
+
+}
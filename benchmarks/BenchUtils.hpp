@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../project/OutputSink.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+namespace Bench {
+
+// Bytes requested from operator new since the start of the program
+uint64_t allocatedBytes();
+
+// Report events/sec and heap bytes allocated per event for a benchmark loop
+// that processed `events` events per iteration.
+void reportEvents(benchmark::State &state, int64_t events, uint64_t bytesBefore);
+
+// Synthetic club day: the 3 config lines and `events` valid event lines
+// (arrivals, seating, waiting and departures) spread over the working hours.
+std::string syntheticDay(int64_t events, int tables, uint32_t seed = 1);
+
+// Sink that formats everything but throws the bytes away
+class NullSink : public Yadro::OutputSink {
+public:
+    void flush() override { m_buffer.clear(); }
+};
+
+}
@@ -0,0 +1,133 @@
+#include "BenchUtils.hpp"
+#include "../project/Parser.hpp"
+#include "../project/Runner.hpp"
+#include "../project/EventLog.hpp"
+#include "../project/DayArena.hpp"
+#include "../project/Pipeline.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Synthetic day written to a temporary file for the lifetime of one benchmark
+class DayFile {
+public:
+    DayFile(int64_t events, int tables) {
+        m_path = (std::filesystem::temp_directory_path() /
+                  ("yadro_bench_" + std::to_string(events) + "_" + std::to_string(tables) + ".txt")).string();
+        std::string text = Bench::syntheticDay(events, tables);
+        m_bytes = text.size();
+        std::ofstream(m_path, std::ios::binary) << text;
+    }
+    ~DayFile() { std::remove(m_path.c_str()); }
+    const std::string &path() const { return m_path; }
+    size_t bytes() const { return m_bytes; }
+private:
+    std::string m_path;
+    size_t m_bytes;
+};
+
+void dayArguments(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"events", "tables"});
+    benchmark->ArgsProduct({{10000, 100000, 1000000, 10000000}, {10, 1000, 100000}});
+    benchmark->Unit(benchmark::kMillisecond);
+}
+
+}
+
+// Whole run: parse, process, endOfDay and format the output
+static void BM_Day(benchmark::State &state) {
+    int64_t events = state.range(0);
+    DayFile day(events, static_cast<int>(state.range(1)));
+    uint64_t bytesBefore = Bench::allocatedBytes();
+    for (auto _ : state) {
+        Bench::NullSink sink;
+        Yadro::runClubFile(day.path(), sink);
+    }
+    Bench::reportEvents(state, events, bytesBefore);
+    state.SetBytesProcessed(static_cast<int64_t>(day.bytes()) * state.iterations());
+}
+BENCHMARK(BM_Day)->Apply(dayArguments);
+
+// Same days run back to back in one arena, as a batch worker runs them
+static void BM_DayInArena(benchmark::State &state) {
+    int64_t events = state.range(0);
+    DayFile day(events, static_cast<int>(state.range(1)));
+    Yadro::DayArena arena;
+    {
+        // One day first, so the block has grown to the size of the day.
+        Bench::NullSink sink;
+        Yadro::runClubFile(day.path(), sink, 1, nullptr, arena.resource());
+        arena.reset();
+    }
+    uint64_t bytesBefore = Bench::allocatedBytes();
+    for (auto _ : state) {
+        Bench::NullSink sink;
+        Yadro::runClubFile(day.path(), sink, 1, nullptr, arena.resource());
+        arena.reset();
+    }
+    Bench::reportEvents(state, events, bytesBefore);
+    state.SetBytesProcessed(static_cast<int64_t>(day.bytes()) * state.iterations());
+}
+BENCHMARK(BM_DayInArena)->Apply(dayArguments);
+
+// Same days with reading, parsing, the club and formatting on four threads
+static void BM_DayPipelined(benchmark::State &state) {
+    int64_t events = state.range(0);
+    DayFile day(events, static_cast<int>(state.range(1)));
+    uint64_t bytesBefore = Bench::allocatedBytes();
+    for (auto _ : state) {
+        Bench::NullSink sink;
+        Yadro::runPipelined(day.path(), sink);
+    }
+    Bench::reportEvents(state, events, bytesBefore);
+    state.SetBytesProcessed(static_cast<int64_t>(day.bytes()) * state.iterations());
+}
+BENCHMARK(BM_DayPipelined)->Apply(dayArguments)->UseRealTime();
+
+// Parsing only, to separate the parser from the club state machine
+static void BM_DayParseOnly(benchmark::State &state) {
+    int64_t events = state.range(0);
+    DayFile day(events, static_cast<int>(state.range(1)));
+    uint64_t bytesBefore = Bench::allocatedBytes();
+    for (auto _ : state) {
+        Yadro::Parser parser(day.path());
+        Yadro::ClubConfig config;
+        Yadro::EventData event;
+        std::string errorLine;
+        parser.ReadConfig(config, errorLine);
+        while (parser.NextEvent(event, errorLine))
+            benchmark::DoNotOptimize(event.time);
+    }
+    Bench::reportEvents(state, events, bytesBefore);
+    state.SetBytesProcessed(static_cast<int64_t>(day.bytes()) * state.iterations());
+}
+BENCHMARK(BM_DayParseOnly)->Apply(dayArguments);
+
+// Same day replayed from the binary event log instead of the text
+static void BM_DayReplay(benchmark::State &state) {
+    int64_t events = state.range(0);
+    DayFile day(events, static_cast<int>(state.range(1)));
+    std::string logPath = day.path() + ".log";
+    int fd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    {
+        Yadro::FdSink log(fd);
+        std::string errorLine;
+        Yadro::EventLog::convert(day.path(), log, errorLine);
+    }
+    ::close(fd);
+    uint64_t bytesBefore = Bench::allocatedBytes();
+    for (auto _ : state) {
+        Bench::NullSink sink;
+        std::string error;
+        Yadro::EventLog::replay(logPath, sink, error);
+    }
+    Bench::reportEvents(state, events, bytesBefore);
+    state.SetBytesProcessed(static_cast<int64_t>(std::filesystem::file_size(logPath)) * state.iterations());
+    std::remove(logPath.c_str());
+}
+BENCHMARK(BM_DayReplay)->Apply(dayArguments);
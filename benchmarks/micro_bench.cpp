@@ -0,0 +1,184 @@
+#include "BenchUtils.hpp"
+#include "../project/Club.hpp"
+#include "../project/Parser.hpp"
+#include "../project/ParserHelpers.hpp"
+#include "../project/Time.hpp"
+#include "../project/Utils.hpp"
+#include <string>
+#include <vector>
+
+using Yadro::Club;
+using Yadro::ClientNames;
+using Yadro::EventData;
+
+namespace {
+
+// Event as the parser would produce it, with the id from a shared name table.
+EventData makeEvent(ClientNames &names, int time, int eventId, const std::string &client, int table = -1) {
+    EventData event;
+    event.time = time;
+    event.eventId = eventId;
+    event.ClientName = client;
+    event.TableNumber = table;
+    event.originalLine = Yadro::Time::ToString(time) + " " + std::to_string(eventId) + " " + client;
+    if (table != -1)
+        event.originalLine += " " + std::to_string(table);
+    event.clientId = names.intern(client);
+    return event;
+}
+
+const std::vector<std::string> kEventLines = {
+    "09:41 1 client1",
+    "10:25 2 client2 2",
+    "11:45 3 client4",
+    "12:33 4 client1",
+};
+
+}
+
+// *************************
+// Time and Util
+// *************************
+
+static void BM_TimeFromString(benchmark::State &state) {
+    const char *times[] = {"09:41", "23:59", "00:00", "12:34"};
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Yadro::Time::FromString(times[i++ % 4]));
+}
+BENCHMARK(BM_TimeFromString);
+
+static void BM_TimeToString(benchmark::State &state) {
+    int minutes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Yadro::Time::ToString(minutes));
+        minutes = (minutes + 7) % 1440;
+    }
+}
+BENCHMARK(BM_TimeToString);
+
+static void BM_SplitString(benchmark::State &state) {
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Yadro::Util::splitString(kEventLines[i++ % kEventLines.size()]));
+}
+BENCHMARK(BM_SplitString);
+
+static void BM_ParseEvent(benchmark::State &state) {
+    Yadro::ClubConfig config{9 * 60, 19 * 60, 3, 10};
+    EventData event;
+    std::string errorLine;
+    size_t i = 0;
+    uint64_t bytesBefore = Bench::allocatedBytes();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Yadro::parseEvent(kEventLines[i++ % kEventLines.size()], event, config, errorLine));
+    Bench::reportEvents(state, 1, bytesBefore);
+}
+BENCHMARK(BM_ParseEvent);
+
+// *************************
+// Club event paths: a fresh club per iteration, the setup events are not timed
+// *************************
+
+namespace {
+
+const int kOpen = 9 * 60;
+const int kClose = 19 * 60;
+
+struct ClubScenario {
+    ClientNames names;
+    std::vector<EventData> setup;
+    std::vector<EventData> measured;
+};
+
+void runScenario(benchmark::State &state, ClubScenario &scenario, int tables) {
+    // Only the allocations of the measured events count, not those of the setup.
+    uint64_t measuredBytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Club club(tables, kOpen, kClose, 10, &scenario.names);
+            for (const auto &event : scenario.setup)
+                club.processEvent(event);
+            uint64_t bytesBefore = Bench::allocatedBytes();
+            state.ResumeTiming();
+            for (const auto &event : scenario.measured)
+                club.processEvent(event);
+            benchmark::DoNotOptimize(club.getRecords().data());
+            state.PauseTiming();
+            measuredBytes += Bench::allocatedBytes() - bytesBefore;
+            // Each scenario times one event path; an error event means it took another.
+            for (const auto &record : club.getRecords()) {
+                if (record.eventId == 13) {
+                    state.SkipWithError("the scenario caused an event 13");
+                    break;
+                }
+            }
+        }
+        if (state.error_occurred())
+            break;
+        state.ResumeTiming();
+    }
+    Bench::reportEvents(state, static_cast<int64_t>(scenario.measured.size()), Bench::allocatedBytes() - measuredBytes);
+}
+
+std::string clientName(int i) {
+    return "client" + std::to_string(i);
+}
+
+}
+
+// Arrivals of distinct clients
+static void BM_ClubEventID1(benchmark::State &state) {
+    int count = static_cast<int>(state.range(0));
+    ClubScenario scenario;
+    for (int i = 0; i < count; i++)
+        scenario.measured.push_back(makeEvent(scenario.names, kOpen + 10, 1, clientName(i)));
+    runScenario(state, scenario, count);
+}
+BENCHMARK(BM_ClubEventID1)->Arg(1000)->Arg(100000);
+
+// Every client sits at its own table, then moves one table up, the last one to the
+// spare table first, so each move takes the table the previous move freed
+static void BM_ClubEventID2(benchmark::State &state) {
+    int count = static_cast<int>(state.range(0));
+    ClubScenario scenario;
+    for (int i = 0; i < count; i++)
+        scenario.setup.push_back(makeEvent(scenario.names, kOpen + 10, 1, clientName(i)));
+    for (int i = 0; i < count; i++)
+        scenario.measured.push_back(makeEvent(scenario.names, kOpen + 20, 2, clientName(i), i + 1));
+    for (int i = count - 1; i >= 0; i--)
+        scenario.measured.push_back(makeEvent(scenario.names, kOpen + 30, 2, clientName(i), i + 2));
+    runScenario(state, scenario, count + 1);
+}
+BENCHMARK(BM_ClubEventID2)->Arg(1000)->Arg(100000);
+
+// All tables are busy: the queue fills up, then overflows (event 11)
+static void BM_ClubEventID3(benchmark::State &state) {
+    int count = static_cast<int>(state.range(0));
+    ClubScenario scenario;
+    for (int i = 0; i < 3 * count; i++)
+        scenario.setup.push_back(makeEvent(scenario.names, kOpen + 10, 1, clientName(i)));
+    for (int i = 0; i < count; i++)
+        scenario.setup.push_back(makeEvent(scenario.names, kOpen + 20, 2, clientName(i), i + 1));
+    for (int i = count; i < 3 * count; i++)
+        scenario.measured.push_back(makeEvent(scenario.names, kOpen + 30, 3, clientName(i)));
+    runScenario(state, scenario, count);
+}
+BENCHMARK(BM_ClubEventID3)->Arg(1000)->Arg(100000);
+
+// Seated clients leave and the waiting ones take their tables (event 12)
+static void BM_ClubEventID4(benchmark::State &state) {
+    int count = static_cast<int>(state.range(0));
+    ClubScenario scenario;
+    for (int i = 0; i < 2 * count; i++)
+        scenario.setup.push_back(makeEvent(scenario.names, kOpen + 10, 1, clientName(i)));
+    for (int i = 0; i < count; i++)
+        scenario.setup.push_back(makeEvent(scenario.names, kOpen + 20, 2, clientName(i), i + 1));
+    for (int i = count; i < 2 * count; i++)
+        scenario.setup.push_back(makeEvent(scenario.names, kOpen + 30, 3, clientName(i)));
+    for (int i = 0; i < 2 * count; i++)
+        scenario.measured.push_back(makeEvent(scenario.names, kOpen + 90, 4, clientName(i)));
+    runScenario(state, scenario, count);
+}
+BENCHMARK(BM_ClubEventID4)->Arg(1000)->Arg(100000);
@@ -0,0 +1,119 @@
+#include "Batch.hpp"
+#include "Runner.hpp"
+#include "OutputSink.hpp"
+#include "ThreadPool.hpp"
+#include "DayArena.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Yadro {
+
+namespace fs = std::filesystem;
+
+bool collectBatchInputs(const std::vector<std::string> &inputs, std::vector<std::string> &files, std::string &error) {
+    for (const auto &input : inputs) {
+        if (!input.empty() && input[0] == '@') {
+            std::ifstream manifest(input.substr(1));
+            if (!manifest) {
+                error = "Error: Cannot open manifest " + input.substr(1);
+                return false;
+            }
+            std::string line;
+            while (std::getline(manifest, line)) {
+                while (!line.empty() && (line.back() == '\r'))
+                    line.pop_back();
+                if (!line.empty())
+                    files.push_back(line);
+            }
+            continue;
+        }
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            std::vector<std::string> entries;
+            for (const auto &entry : fs::directory_iterator(input, ec)) {
+                if (entry.is_regular_file(ec))
+                    entries.push_back(entry.path().string());
+            }
+            if (ec) {
+                error = "Error: Cannot read directory " + input;
+                return false;
+            }
+            std::sort(entries.begin(), entries.end());
+            files.insert(files.end(), entries.begin(), entries.end());
+            continue;
+        }
+        files.push_back(input);
+    }
+    return true;
+}
+
+std::string batchOutputPath(const std::string &input, const std::string &outputDir) {
+    std::string name = fs::path(input).filename().string();
+    const std::string inSuffix = ".in.txt";
+    if (name.size() > inSuffix.size() && name.compare(name.size() - inSuffix.size(), inSuffix.size(), inSuffix) == 0)
+        name.replace(name.size() - inSuffix.size(), inSuffix.size(), ".out.txt");
+    else
+        name += ".out";
+    return (fs::path(outputDir) / name).string();
+}
+
+int runBatch(const BatchOptions &options, std::vector<std::string> &errors) {
+    std::vector<std::string> files;
+    std::string error;
+    if (!collectBatchInputs(options.inputs, files, error)) {
+        errors.push_back(error);
+        return 1;
+    }
+    std::vector<std::string> outputs;
+    std::set<std::string> seen;
+    for (const auto &file : files) {
+        outputs.push_back(batchOutputPath(file, options.outputDir));
+        if (!seen.insert(outputs.back()).second) {
+            errors.push_back("Error: Two inputs write to " + outputs.back());
+            return 1;
+        }
+    }
+
+    // Every task owns its Parser, Club and output file, so nothing is shared.
+    std::vector<std::string> taskErrors(files.size());
+    {
+        ThreadPool pool(options.jobs);
+        for (size_t i = 0; i < files.size(); i++) {
+            pool.submit([&files, &outputs, &taskErrors, &options, i] {
+                int fd = ::open(outputs[i].c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0) {
+                    taskErrors[i] = "Error: Cannot create file " + outputs[i];
+                    return;
+                }
+                // Days run back to back on a worker reuse its arena instead of the heap.
+                thread_local DayArena arena;
+                bool written;
+                {
+                    FdSink out(fd);
+                    runClubFile(files[i], out, 1, nullptr, arena.resource(), options.outputMode);
+                    out.flush();
+                    written = out.good();
+                }
+                arena.reset();
+                if (::close(fd) != 0 || !written)
+                    taskErrors[i] = "Error: Cannot write file " + outputs[i];
+            });
+        }
+        pool.wait();
+    }
+
+    int failed = 0;
+    for (auto &taskError : taskErrors) {
+        if (!taskError.empty()) {
+            errors.push_back(std::move(taskError));
+            failed++;
+        }
+    }
+    return failed;
+}
+
+}
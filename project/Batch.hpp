@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Club.hpp"
+#include <string>
+#include <vector>
+
+namespace Yadro {
+
+struct BatchOptions {
+    std::vector<std::string> inputs; // files, directories or @manifest files
+    std::string outputDir = ".";
+    unsigned jobs = 0;               // 0 means one worker per core
+    OutputMode outputMode = OutputMode::Full;
+};
+
+// Expand directories (their regular files, sorted) and manifests (one path per
+// line) into the list of input files.
+bool collectBatchInputs(const std::vector<std::string> &inputs, std::vector<std::string> &files, std::string &error);
+
+// Output file for an input: "name.in.txt" gives "name.out.txt", anything else gets ".out".
+std::string batchOutputPath(const std::string &input, const std::string &outputDir);
+
+// Run every input file as an independent club day on a thread pool, each into
+// its own output file. Returns the number of files whose output could not be written.
+int runBatch(const BatchOptions &options, std::vector<std::string> &errors);
+
+}
@@ -0,0 +1,124 @@
+#include "yadro.h"
+#include "Library.hpp"
+#include <memory>
+#include <optional>
+
+// The handle holds the C++ result; no exception may cross the C boundary.
+struct yadro_day {
+    std::optional<Yadro::DayStream> stream;  // until the day is finished
+    Yadro::DayResult result;
+};
+
+namespace {
+
+bool toOutputMode(int mode, Yadro::OutputMode &outputMode) {
+    switch (mode) {
+    case YADRO_OUTPUT_FULL: outputMode = Yadro::OutputMode::Full; return true;
+    case YADRO_OUTPUT_REPORT: outputMode = Yadro::OutputMode::ReportOnly; return true;
+    case YADRO_OUTPUT_ERRORS: outputMode = Yadro::OutputMode::ErrorsOnly; return true;
+    case YADRO_OUTPUT_SUMMARY: outputMode = Yadro::OutputMode::Summary; return true;
+    }
+    return false;
+}
+
+}
+
+extern "C" {
+
+int yadro_api_version(void) {
+    return YADRO_API_VERSION;
+}
+
+yadro_day *yadro_run(const char *data, size_t size, int mode) {
+    Yadro::OutputMode outputMode;
+    if (!toOutputMode(mode, outputMode))
+        return nullptr;
+    try {
+        auto day = std::make_unique<yadro_day>();
+        day->result = Yadro::runDay(std::string_view(data, size), outputMode);
+        return day.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+yadro_day *yadro_stream_open(int mode) {
+    Yadro::OutputMode outputMode;
+    if (!toOutputMode(mode, outputMode))
+        return nullptr;
+    try {
+        auto day = std::make_unique<yadro_day>();
+        day->stream.emplace(outputMode);
+        return day.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+int yadro_stream_feed(yadro_day *day, const char *data, size_t size) {
+    if (!day->stream.has_value())
+        return 0;
+    try {
+        return day->stream->feed(std::string_view(data, size)) ? 1 : 0;
+    } catch (...) {
+        // The day cannot go on; it reads as rejected from now on.
+        day->result = Yadro::DayResult();
+        day->stream.reset();
+        return 0;
+    }
+}
+
+void yadro_stream_finish(yadro_day *day) {
+    if (!day->stream.has_value())
+        return;
+    try {
+        day->result = day->stream->finish();
+    } catch (...) {
+        day->result = Yadro::DayResult();
+    }
+    day->stream.reset();
+}
+
+int yadro_accepted(const yadro_day *day) {
+    return day->result.accepted ? 1 : 0;
+}
+
+const char *yadro_error_line(const yadro_day *day) {
+    return day->result.errorLine.c_str();
+}
+
+const char *yadro_output(const yadro_day *day, size_t *size) {
+    if (size != nullptr)
+        *size = day->result.text.size();
+    return day->result.text.c_str();
+}
+
+size_t yadro_event_count(const yadro_day *day) {
+    return day->result.events.size();
+}
+
+int yadro_event_at(const yadro_day *day, size_t index, yadro_event *event) {
+    if (index >= day->result.events.size())
+        return 0;
+    const Yadro::DayEvent &source = day->result.events[index];
+    *event = {source.time, source.eventId, source.client.c_str(), source.table, source.error.c_str()};
+    return 1;
+}
+
+size_t yadro_table_count(const yadro_day *day) {
+    return day->result.tables.size();
+}
+
+int yadro_table_at(const yadro_day *day, size_t index, yadro_table *table) {
+    if (index >= day->result.tables.size())
+        return 0;
+    const Yadro::DayTable &source = day->result.tables[index];
+    *table = {source.number, source.revenue, source.occupied};
+    return 1;
+}
+
+void yadro_free(yadro_day *day) {
+    delete day;
+}
+
+}
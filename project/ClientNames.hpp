@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Yadro {
+
+using ClientId = int;
+constexpr ClientId kNoClient = -1;
+
+// Transparent string hash: maps keyed by a string are looked up by string_view
+// without building a key.
+struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+};
+
+// Interning table: each distinct client name gets a dense id 0, 1, 2, ...
+// so that the club state can be kept in arrays indexed by id.
+// The names and the map nodes are allocated from memory.
+class ClientNames {
+public:
+    explicit ClientNames(std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+        : m_ids(memory), m_names(memory) {}
+    ClientNames(const ClientNames &) = delete;
+    ClientNames &operator=(const ClientNames &) = delete;
+    ClientNames(ClientNames &&) = default;
+    ClientNames &operator=(ClientNames &&) = default;
+
+    ClientId intern(std::string_view name) {
+        auto it = m_ids.find(name);
+        if (it != m_ids.end())
+            return it->second;
+        ClientId id = static_cast<ClientId>(m_names.size());
+        auto inserted = m_ids.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(id)).first;
+        // Map nodes never move, so the key can be referenced by id.
+        m_names.push_back(&inserted->first);
+        return id;
+    }
+
+    ClientId find(std::string_view name) const {
+        auto it = m_ids.find(name);
+        return it == m_ids.end() ? kNoClient : it->second;
+    }
+
+    std::string_view name(ClientId id) const { return *m_names[id]; }
+    size_t size() const { return m_names.size(); }
+private:
+    std::pmr::unordered_map<std::pmr::string, ClientId, NameHash, std::equal_to<>> m_ids;
+    std::pmr::vector<const std::pmr::string *> m_names;
+};
+
+}
@@ -1,16 +1,114 @@
 #include "Club.hpp"
 #include "Time.hpp"
-#include <sstream>
 #include <algorithm>
+#include <cassert>
+#include <charconv>
 
 namespace Yadro {
 
-Club::Club(int tablesnum, int openTime, int closeTime, int hourlyCost)
-    : m_tablesCount(tablesnum), m_openTime(openTime), m_closeTime(closeTime), m_hourlyCost(hourlyCost) {
+namespace {
+
+// Checkpoint layout, all integers little-endian:
+//   "YCLB", version, tables count, open time, close time, hourly cost, events processed (u64),
+//   names count, then per name: length and bytes, in id order,
+//   per client: in club (u8) and table number,
+//   per table: occupied (u8), current client, start time, total occupied, revenue,
+//   waiting queue length, then the queued client ids from the front.
+constexpr std::string_view kCheckpointMagic = "YCLB";
+constexpr uint32_t kCheckpointVersion = 1;
+
+void putU8(std::string &data, uint8_t value) {
+    data.push_back(static_cast<char>(value));
+}
+
+void putU32(std::string &data, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8)
+        data.push_back(static_cast<char>(value >> shift));
+}
+
+void putU64(std::string &data, uint64_t value) {
+    putU32(data, static_cast<uint32_t>(value));
+    putU32(data, static_cast<uint32_t>(value >> 32));
+}
+
+// Bounds-checked reading: after the first short read every value is 0 and ok() is false.
+class CheckpointReader {
+public:
+    explicit CheckpointReader(std::string_view data) : m_data(data) {}
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_data.empty(); }
+
+    std::string_view bytes(size_t count) {
+        if (!m_ok || m_data.size() < count) {
+            m_ok = false;
+            return {};
+        }
+        std::string_view result = m_data.substr(0, count);
+        m_data.remove_prefix(count);
+        return result;
+    }
+    uint8_t u8() {
+        std::string_view byte = bytes(1);
+        return byte.empty() ? 0 : static_cast<uint8_t>(byte[0]);
+    }
+    uint32_t u32() {
+        std::string_view raw = bytes(4);
+        uint32_t value = 0;
+        for (size_t i = 0; i < raw.size(); i++)
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(raw[i])) << (8 * i);
+        return value;
+    }
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+    uint64_t u64() {
+        uint64_t low = u32();
+        return low | (static_cast<uint64_t>(u32()) << 32);
+    }
+private:
+    std::string_view m_data;
+    bool m_ok = true;
+};
+
+bool readCheckpointHeader(CheckpointReader &reader, ClubConfig &config) {
+    if (reader.bytes(kCheckpointMagic.size()) != kCheckpointMagic || reader.u32() != kCheckpointVersion)
+        return false;
+    config.numTables = reader.i32();
+    config.openTime = reader.i32();
+    config.closeTime = reader.i32();
+    config.hourlyCost = reader.i32();
+    return reader.ok() && config.numTables > 0;
+}
+
+}
+
+std::string_view errorName(ClubError error) {
+    switch (error) {
+    case ClubError::NotOpenYet: return "NotOpenYet";
+    case ClubError::YouShallNotPass: return "YouShallNotPass";
+    case ClubError::ClientUnknown: return "ClientUnknown";
+    case ClubError::InvalidTableNumber: return "InvalidTableNumber";
+    case ClubError::PlaceIsBusy: return "PlaceIsBusy";
+    case ClubError::ICanWaitNoLonger: return "ICanWaitNoLonger!";
+    }
+    return "";
+}
+
+Club::Club(int tablesnum, int openTime, int closeTime, int hourlyCost, ClientNames *names,
+           std::pmr::memory_resource *memory)
+    : m_tablesCount(tablesnum), m_openTime(openTime), m_closeTime(closeTime), m_hourlyCost(hourlyCost),
+      m_memory(memory), m_tables(memory), m_freeTables(tablesnum, memory), m_sharedNames(names),
+      m_names(names != nullptr ? names : &m_ownNames), m_ownNames(memory),
+      m_clients(memory), m_waitingQueue(memory), m_outputRecords(memory), m_rawLines(memory), m_sessions(memory) {
+    m_tables.reserve(m_tablesCount);
     for (int i = 1; i <= m_tablesCount; i++)
         m_tables.push_back(static_cast<Table>(i));
 }
 
+Club::Club(int tablesnum, int openTime, int closeTime, int hourlyCost, const ClientNames *names,
+           std::pmr::memory_resource *memory)
+    : Club(tablesnum, openTime, closeTime, hourlyCost, static_cast<ClientNames *>(nullptr), memory) {
+    m_names = names;
+}
+
 std::string Club::getOpenTimeStr() const {
     return Time::ToString(m_openTime);
 }
@@ -20,103 +118,241 @@ std::string Club::getCloseTimeStr() const {
 }
 
 const std::vector<std::string>& Club::getOutput() const {
-    return m_outputEvents;
+    // Render only the records added since the last call.
+    MemorySink sink;
+    for (size_t i = m_renderedOutput.size(); i < m_outputRecords.size(); i++) {
+        sink.clear();
+        renderRecord(m_outputRecords[i], sink);
+        m_renderedOutput.emplace_back(sink.data().substr(0, sink.data().size() - 1));
+    }
+    return m_renderedOutput;
 }
 
-void Club::addOutputEvent(const std::string &event) {
-    m_outputEvents.push_back(event);
+void Club::addOutputEvent(int time, int eventId, ClientId client, int value) {
+    if (m_outputMode != OutputMode::Full && (eventId != 13 || m_outputMode != OutputMode::ErrorsOnly))
+        return;
+    m_outputRecords.push_back({client, value, static_cast<int16_t>(time), static_cast<uint8_t>(eventId)});
+}
+
+void Club::addInputEcho(const EventView &event, ClientId client) {
+    if (m_outputMode != OutputMode::Full)
+        return;
+    // An event without its line, or whose record renders back to exactly that line.
+    if (event.line.empty()
+        || isCanonicalLine(event.line, event.time, event.eventId, names().name(client), event.tableNumber)) {
+        addOutputEvent(event.time, event.eventId, client, event.eventId == 2 ? event.tableNumber : 0);
+        return;
+    }
+    addOutputEvent(event.time, OutputRecord::kRawLine, client, static_cast<int>(m_rawLines.size()));
+    m_rawLines.emplace_back(event.line);
+}
+
+bool isCanonicalLine(std::string_view line, int time, int eventId, std::string_view name, int table) {
+    char text[Time::kMaxLength];
+    std::string_view timeText(text, Time::Format(time, text));
+    if (line.substr(0, timeText.size()) != timeText)
+        return false;
+    line.remove_prefix(timeText.size());
+    if (line.size() < 3 || line[0] != ' ' || line[1] != static_cast<char>('0' + eventId) || line[2] != ' ')
+        return false;
+    line.remove_prefix(3);
+    if (line.substr(0, name.size()) != name)
+        return false;
+    line.remove_prefix(name.size());
+    if (eventId != 2)
+        return line.empty();
+    char digits[16];
+    std::string_view tableText(digits, std::to_chars(digits, digits + sizeof(digits), table).ptr - digits);
+    return line.size() == tableText.size() + 1 && line[0] == ' ' && line.substr(1) == tableText;
+}
+
+void writeRecord(const OutputRecord &record, std::string_view text, OutputSink &sink) {
+    if (record.eventId == OutputRecord::kRawLine)
+        return;
+    sink.appendTime(record.time).appendChar(' ').appendInt(record.eventId).appendChar(' ').append(text);
+    if (record.eventId == 2 || record.eventId == 12)
+        sink.appendChar(' ').appendInt(record.value);
+    sink.endLine();
+}
+
+void Club::renderRecord(const OutputRecord &record, OutputSink &sink) const {
+    if (record.eventId == OutputRecord::kRawLine)
+        sink.line(m_rawLines[record.value]);
+    else if (record.eventId == 13)
+        writeRecord(record, errorName(static_cast<ClubError>(record.value)), sink);
+    else
+        writeRecord(record, names().name(record.client), sink);
 }
 
 int Club::computeClientRevenue(int minutes) const {
     return ((minutes + 59) / 60) * m_hourlyCost;
 }
 
+ClientId Club::clientIdOf(const EventData &event) {
+    ClientId client = event.clientId;
+    // Ids are only meaningful when they come from the same interning table.
+    if (m_sharedNames == nullptr || client == kNoClient)
+        return internClient(event.ClientName);
+    if (client >= static_cast<ClientId>(m_clients.size()))
+        m_clients.resize(names().size());
+    return client;
+}
+
+ClientNames &Club::writableNames() {
+    // Interning into names other threads read would be a data race.
+    assert(m_names == m_sharedNames || m_names == &m_ownNames);
+    return m_sharedNames != nullptr ? *m_sharedNames : m_ownNames;
+}
+
+ClientId Club::internClient(std::string_view name) {
+    ClientId client = writableNames().intern(name);
+    if (client >= static_cast<ClientId>(m_clients.size()))
+        m_clients.resize(names().size());
+    return client;
+}
+
+void Club::setStats(RunStats *stats) {
+    m_stats = stats;
+    if (m_stats != nullptr) {
+        // The clients already in the club, e.g. after a restore, are counted from here on.
+        m_stats->clientsInClub = static_cast<int>(std::count_if(m_clients.begin(), m_clients.end(),
+            [](const ClientState &state) { return state.inClub; }));
+        m_stats->peakClients = std::max(m_stats->peakClients, m_stats->clientsInClub);
+    }
+}
+
+void Club::recordSessions(bool enabled) {
+    m_recordSessions = enabled;
+    m_sessionIndexStale = true;
+}
+
+const SessionIndex &Club::sessions() const {
+    if (m_sessionIndexStale) {
+        std::vector<Session> sessions(m_sessions.begin(), m_sessions.end());
+        if (m_recordSessions) {
+            for (const auto &table : m_tables) {
+                if (table.occupied)
+                    sessions.push_back({table.startTime, SessionIndex::kOpen, table.currentClient, table.number});
+            }
+        }
+        m_sessionIndex.build(std::move(sessions), m_tablesCount);
+        m_sessionIndexStale = false;
+    }
+    return m_sessionIndex;
+}
+
 void Club::processEvent(const EventData &event) {
-    addOutputEvent(event.originalLine);
+    EventView view{event.time, event.eventId, event.TableNumber, event.ClientName, event.originalLine};
+    applyEvent(view, clientIdOf(event));
+}
+
+void Club::processEvent(const EventView &event) {
+    applyEvent(event, internClient(event.clientName));
+}
+
+void Club::processEvent(const EventView &event, ClientId client) {
+    if (client >= static_cast<ClientId>(m_clients.size()))
+        m_clients.resize(names().size());
+    applyEvent(event, client);
+}
+
+void Club::applyEvent(const EventView &event, ClientId client) {
+    m_eventsProcessed++;
+    m_sessionIndexStale = true;
+    if (m_stats != nullptr)
+        m_stats->eventsById[event.eventId]++;
+    addInputEcho(event, client);
     if (event.eventId == 1)
-        processEventID1(event.time, event.ClientName);
+        processEventID1(event.time, client);
     else if (event.eventId == 2)
-        processEventID2(event.time, event.ClientName, event.TableNumber);
+        processEventID2(event.time, client, event.tableNumber);
     else if (event.eventId == 3)
-        processEventID3(event.time, event.ClientName);
+        processEventID3(event.time, client);
     else if (event.eventId == 4)
-        processEventID4(event.time, event.ClientName);
+        processEventID4(event.time, client);
 }
 
-void Club::processEventID1(int time, const std::string &client) {
+void Club::processEventID1(int time, ClientId client) {
     if (time < m_openTime || time > m_closeTime) {
-        processErrorEvent(time, "NotOpenYet");
+        processErrorEvent(time, ClubError::NotOpenYet);
         return;
     }
-    if (m_currentClients.find(client) != m_currentClients.end()) {
-        processErrorEvent(time, "YouShallNotPass");
+    if (m_clients[client].inClub) {
+        processErrorEvent(time, ClubError::YouShallNotPass);
         return;
     }
-    m_currentClients.insert(client);
+    m_clients[client].inClub = true;
+    if (m_stats != nullptr) {
+        m_stats->clientsInClub++;
+        m_stats->peakClients = std::max(m_stats->peakClients, m_stats->clientsInClub);
+    }
 }
 
-void Club::processEventID2(int time, const std::string &client, int tableNumber) {
-    if (m_currentClients.find(client) == m_currentClients.end()) {
-        processErrorEvent(time, "ClientUnknown");
+void Club::processEventID2(int time, ClientId client, int tableNumber) {
+    if (!m_clients[client].inClub) {
+        processErrorEvent(time, ClubError::ClientUnknown);
         return;
     }
     if (tableNumber < 1 || tableNumber > m_tablesCount) {
-        processErrorEvent(time, "InvalidTableNumber");
+        processErrorEvent(time, ClubError::InvalidTableNumber);
         return;
     }
     int tableIndex = tableNumber - 1;
     if (m_tables[tableIndex].occupied) {
-        processErrorEvent(time, "PlaceIsBusy");
+        processErrorEvent(time, ClubError::PlaceIsBusy);
         return;
     }
-    if (m_seatedClients.find(client) != m_seatedClients.end()) {
-        int oldTableNum = m_seatedClients[client];
+    if (m_clients[client].table != 0) {
+        int oldTableNum = m_clients[client].table;
         int oldTableIndex = oldTableNum - 1;
         freeTable(oldTableIndex, time);
     }
     m_tables[tableIndex].occupied = true;
     m_tables[tableIndex].currentClient = client;
     m_tables[tableIndex].startTime = time;
-    m_seatedClients[client] = tableNumber;
+    m_freeTables.markBusy(tableIndex);
+    m_clients[client].table = tableNumber;
+    if (m_stats != nullptr)
+        m_stats->tableTurnovers++;
 }
 
-void Club::processEventID3(int time, const std::string &client) {
-    bool freeExists = false;
-    for (const auto &table : m_tables) {
-        if (!table.occupied) {
-            freeExists = true;
-            break;
-        }
-    }
-    if (freeExists) {
-        processErrorEvent(time, "ICanWaitNoLonger!");
+void Club::processEventID3(int time, ClientId client) {
+    if (m_freeTables.any()) {
+        processErrorEvent(time, ClubError::ICanWaitNoLonger);
         return;
     }
-    if (std::find(m_waitingQueue.begin(), m_waitingQueue.end(), client) == m_waitingQueue.end())
-        m_waitingQueue.push_back(client);
+    m_waitingQueue.push(client);
     if (static_cast<int>(m_waitingQueue.size()) > m_tablesCount) {
-        m_waitingQueue.erase(std::remove(m_waitingQueue.begin(), m_waitingQueue.end(), client), m_waitingQueue.end());
-        m_currentClients.erase(client);
-        m_seatedClients.erase(client);
-        std::ostringstream oss;
-        oss << Time::ToString(time) << " 11 " << client;
-        addOutputEvent(oss.str());
+        m_waitingQueue.remove(client);
+        if (m_stats != nullptr && m_clients[client].inClub)
+            m_stats->clientsInClub--;
+        m_clients[client].inClub = false;
+        m_clients[client].table = 0;
+        addOutputEvent(time, 11, client);
+        if (m_stats != nullptr) {
+            m_stats->clientsSentAway++;
+            m_stats->queueOverflows++;
+        }
     }
+    if (m_stats != nullptr)
+        m_stats->peakQueue = std::max(m_stats->peakQueue, m_waitingQueue.size());
 }
 
-void Club::processEventID4(int time, const std::string &client) {
-    if (m_currentClients.find(client) == m_currentClients.end()) {
-        processErrorEvent(time, "ClientUnknown");
+void Club::processEventID4(int time, ClientId client) {
+    if (!m_clients[client].inClub) {
+        processErrorEvent(time, ClubError::ClientUnknown);
         return;
     }
-    if (m_seatedClients.find(client) != m_seatedClients.end()) {
-        int tableNum = m_seatedClients[client];
+    if (m_clients[client].table != 0) {
+        int tableNum = m_clients[client].table;
         int tableIndex = tableNum - 1;
         freeTable(tableIndex, time);
     } else {
-        m_waitingQueue.erase(std::remove(m_waitingQueue.begin(), m_waitingQueue.end(), client), m_waitingQueue.end());
+        m_waitingQueue.remove(client);
     }
-    m_currentClients.erase(client);
+    m_clients[client].inClub = false;
+    if (m_stats != nullptr)
+        m_stats->clientsInClub--;
 }
 
 void Club::freeTable(int tableIndex, int eventTime) {
@@ -126,10 +362,15 @@ void Club::freeTable(int tableIndex, int eventTime) {
             duration = 0;
         m_tables[tableIndex].totalOccupied += duration;
         m_tables[tableIndex].revenue += computeClientRevenue(duration);
-        std::string client = m_tables[tableIndex].currentClient;
+        ClientId client = m_tables[tableIndex].currentClient;
+        if (m_recordSessions) {
+            int start = m_tables[tableIndex].startTime;
+            m_sessions.push_back({start, start + duration, client, m_tables[tableIndex].number});
+        }
         m_tables[tableIndex].occupied = false;
-        m_tables[tableIndex].currentClient = "";
-        m_seatedClients.erase(client);
+        m_tables[tableIndex].currentClient = kNoClient;
+        m_freeTables.markFree(tableIndex);
+        m_clients[client].table = 0;
 
         if (eventTime != m_closeTime) {
             assignTableToWaiting(tableIndex, eventTime);
@@ -140,46 +381,203 @@ void Club::freeTable(int tableIndex, int eventTime) {
 void Club::assignTableToWaiting(int tableIndex, int eventTime) {
     if (m_waitingQueue.empty())
         return;
-    std::string client = m_waitingQueue.front();
-    m_waitingQueue.erase(m_waitingQueue.begin());
+    ClientId client = m_waitingQueue.pop();
     m_tables[tableIndex].occupied = true;
     m_tables[tableIndex].currentClient = client;
     m_tables[tableIndex].startTime = eventTime;
-    m_seatedClients[client] = m_tables[tableIndex].number;
-    std::ostringstream oss;
-    oss << Time::ToString(eventTime) << " 12 " << client << " " << m_tables[tableIndex].number;
-    addOutputEvent(oss.str());
+    m_freeTables.markBusy(tableIndex);
+    m_clients[client].table = m_tables[tableIndex].number;
+    addOutputEvent(eventTime, 12, client, m_tables[tableIndex].number);
+    if (m_stats != nullptr) {
+        m_stats->seatedFromQueue++;
+        m_stats->tableTurnovers++;
+    }
 }
 
-void Club::processErrorEvent(int time, const std::string &errorMsg) {
-    std::ostringstream oss;
-    oss << Time::ToString(time) << " 13 " << errorMsg;
-    addOutputEvent(oss.str());
+void Club::processErrorEvent(int time, ClubError error) {
+    addOutputEvent(time, 13, kNoClient, static_cast<int>(error));
+    if (m_stats != nullptr)
+        m_stats->errors[static_cast<size_t>(error)]++;
 }
 
 void Club::endOfDay() {
+    m_sessionIndexStale = true;
     for (auto &table : m_tables) {
         if (table.occupied)
             freeTable(table.number - 1, m_closeTime);
     }
-    std::vector<std::string> remainingClients(m_currentClients.begin(), m_currentClients.end());
-    std::sort(remainingClients.begin(), remainingClients.end());
-    for (const auto &client : remainingClients) {
-        std::ostringstream oss;
-        oss << Time::ToString(m_closeTime) << " 11 " << client;
-        addOutputEvent(oss.str());
+    // Names are only compared here, once per remaining client.
+    std::vector<ClientId> remainingClients;
+    for (ClientId client = 0; client < static_cast<ClientId>(m_clients.size()); client++) {
+        if (m_clients[client].inClub)
+            remainingClients.push_back(client);
     }
+    const ClientNames &clientNames = names();
+    std::sort(remainingClients.begin(), remainingClients.end(), [&clientNames](ClientId a, ClientId b) {
+        return clientNames.name(a) < clientNames.name(b);
+    });
+    for (ClientId client : remainingClients) {
+        addOutputEvent(m_closeTime, 11, client);
+    }
+    if (m_stats != nullptr)
+        m_stats->clientsSentAway += remainingClients.size();
 }
 
 std::vector<std::string> Club::getReport() const {
     std::vector<std::string> report;
     for (const auto &table : m_tables) {
         std::string occTime = Time::ToString(table.totalOccupied);
-        std::ostringstream oss;
-        oss << table.number << " " << table.revenue << " " << occTime;
-        report.push_back(oss.str());
+        report.push_back(std::to_string(table.number) + " " + std::to_string(table.revenue) + " " + occTime);
     }
     return report;
 }
 
-}
\ No newline at end of file
+void Club::writeOutput(OutputSink &sink) const {
+    writeOutput(sink, 0);
+}
+
+void Club::writeOutput(OutputSink &sink, size_t first) const {
+    for (size_t i = first; i < m_outputRecords.size(); i++)
+        renderRecord(m_outputRecords[i], sink);
+}
+
+void Club::discardOutput() {
+    m_outputRecords.clear();
+    m_rawLines.clear();
+    m_renderedOutput.clear();
+}
+
+long long Club::revenue() const {
+    long long total = 0;
+    for (const auto &table : m_tables)
+        total += table.revenue;
+    return total;
+}
+
+void Club::writeReport(OutputSink &sink) const {
+    for (const auto &table : m_tables) {
+        sink.appendInt(table.number).appendChar(' ').appendInt(table.revenue).appendChar(' ')
+            .appendTime(table.totalOccupied).endLine();
+    }
+}
+
+void Club::writeSummary(OutputSink &sink) const {
+    long long revenue = 0;
+    long long occupied = 0;
+    for (const auto &table : m_tables) {
+        revenue += table.revenue;
+        occupied += table.totalOccupied;
+    }
+    sink.append("total ").appendInt(revenue).appendChar(' ').appendTime(static_cast<int>(occupied)).endLine();
+}
+
+void Club::saveCheckpoint(std::string &data) const {
+    const ClientNames &clientNames = names();
+    data.append(kCheckpointMagic);
+    putU32(data, kCheckpointVersion);
+    putU32(data, m_tablesCount);
+    putU32(data, m_openTime);
+    putU32(data, m_closeTime);
+    putU32(data, m_hourlyCost);
+    putU64(data, m_eventsProcessed);
+    putU32(data, static_cast<uint32_t>(clientNames.size()));
+    for (ClientId client = 0; client < static_cast<ClientId>(clientNames.size()); client++) {
+        std::string_view name = clientNames.name(client);
+        putU32(data, static_cast<uint32_t>(name.size()));
+        data.append(name);
+    }
+    for (ClientId client = 0; client < static_cast<ClientId>(clientNames.size()); client++) {
+        ClientState state = client < static_cast<ClientId>(m_clients.size()) ? m_clients[client] : ClientState();
+        putU8(data, state.inClub);
+        putU32(data, state.table);
+    }
+    for (const auto &table : m_tables) {
+        putU8(data, table.occupied);
+        putU32(data, table.currentClient);
+        putU32(data, table.startTime);
+        putU32(data, table.totalOccupied);
+        putU32(data, table.revenue);
+    }
+    putU32(data, static_cast<uint32_t>(m_waitingQueue.size()));
+    m_waitingQueue.forEach([&data](ClientId client) { putU32(data, client); });
+}
+
+bool Club::checkpointConfig(std::string_view data, ClubConfig &config) {
+    CheckpointReader reader(data);
+    return readCheckpointHeader(reader, config);
+}
+
+bool Club::restoreCheckpoint(std::string_view data) {
+    CheckpointReader reader(data);
+    ClubConfig config;
+    if (!readCheckpointHeader(reader, config) || config.numTables != m_tablesCount || config.openTime != m_openTime
+        || config.closeTime != m_closeTime || config.hourlyCost != m_hourlyCost)
+        return false;
+    uint64_t eventsProcessed = reader.u64();
+
+    // Read and check everything before touching the state.
+    uint32_t namesCount = reader.u32();
+    std::vector<std::string_view> savedNames;
+    for (uint32_t i = 0; i < namesCount && reader.ok(); i++)
+        savedNames.push_back(reader.bytes(reader.u32()));
+    std::vector<ClientState> savedClients;
+    for (uint32_t i = 0; i < namesCount && reader.ok(); i++) {
+        ClientState state;
+        state.inClub = reader.u8() != 0;
+        state.table = reader.i32();
+        if (state.table < 0 || state.table > m_tablesCount)
+            return false;
+        savedClients.push_back(state);
+    }
+    std::vector<Table> savedTables;
+    for (int number = 1; number <= m_tablesCount && reader.ok(); number++) {
+        Table table(number);
+        table.occupied = reader.u8() != 0;
+        table.currentClient = reader.i32();
+        table.startTime = reader.i32();
+        table.totalOccupied = reader.i32();
+        table.revenue = reader.i32();
+        if (table.occupied != (table.currentClient >= 0 && table.currentClient < static_cast<ClientId>(namesCount))
+            || (!table.occupied && table.currentClient != kNoClient))
+            return false;
+        savedTables.push_back(table);
+    }
+    uint32_t queueLength = reader.u32();
+    std::vector<ClientId> savedQueue;
+    for (uint32_t i = 0; i < queueLength && reader.ok(); i++) {
+        ClientId client = reader.i32();
+        if (client < 0 || client >= static_cast<ClientId>(namesCount))
+            return false;
+        savedQueue.push_back(client);
+    }
+    if (!reader.ok() || !reader.atEnd())
+        return false;
+
+    // The names table may be shared and already hold other names, so ids are mapped.
+    std::vector<ClientId> ids;
+    for (std::string_view name : savedNames)
+        ids.push_back(writableNames().intern(name));
+    m_clients.assign(names().size(), ClientState());
+    for (uint32_t i = 0; i < namesCount; i++)
+        m_clients[ids[i]] = savedClients[i];
+    m_tables.assign(savedTables.begin(), savedTables.end());
+    m_freeTables = FreeTables(m_tablesCount, m_memory);
+    for (auto &table : m_tables) {
+        if (table.occupied) {
+            table.currentClient = ids[table.currentClient];
+            m_freeTables.markBusy(table.number - 1);
+        }
+    }
+    m_waitingQueue = WaitingQueue(m_memory);
+    for (ClientId client : savedQueue)
+        m_waitingQueue.push(ids[client]);
+    m_outputRecords.clear();
+    m_rawLines.clear();
+    m_renderedOutput.clear();
+    m_eventsProcessed = eventsProcessed;
+    m_sessions.clear();
+    m_sessionIndexStale = true;
+    return true;
+}
+
+}
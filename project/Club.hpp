@@ -1,54 +1,185 @@
 #pragma once
 
 #include "Parser.hpp"
+#include "ClientNames.hpp"
+#include "WaitingQueue.hpp"
+#include "FreeTables.hpp"
+#include "OutputSink.hpp"
+#include "Stats.hpp"
+#include "SessionIndex.hpp"
+#include <memory_resource>
 #include <vector>
-#include <set>
-#include <unordered_map>
 #include <string>
+#include <string_view>
+#include <cstdint>
 
 namespace Yadro {
 
 struct Table {
     int number;              // id number of the Table   
     bool occupied;         
-    std::string currentClient; 
+    ClientId currentClient; 
     int startTime;          
     int totalOccupied;      // Total time occupied in minutes
     int revenue;  
 
-    Table(int num) : number(num), occupied(false), startTime(0), totalOccupied(0), revenue(0) {}
+    Table(int num) : number(num), occupied(false), currentClient(kNoClient), startTime(0), totalOccupied(0), revenue(0) {}
+};
+
+// Per-client state, indexed by ClientId
+struct ClientState {
+    bool inClub = false;
+    int table = 0;           // number of the table the client sits at, 0 if none
+};
+
+enum class ClubError : uint8_t {
+    NotOpenYet,
+    YouShallNotPass,
+    ClientUnknown,
+    InvalidTableNumber,
+    PlaceIsBusy,
+    ICanWaitNoLonger,
+};
+
+// Text of the error as printed in event 13
+std::string_view errorName(ClubError error);
+
+// One line of the club output, kept typed and rendered to text only when consumed.
+struct OutputRecord {
+    static constexpr uint8_t kRawLine = 0; // echoed input line that is kept as text
+
+    ClientId client;   // kNoClient for event 13
+    int32_t value;     // table number (events 2, 12), ClubError (13) or raw line index
+    int16_t time;
+    uint8_t eventId;   // 1-4 echoed input event, 11-13 generated event, or kRawLine
+};
+
+// Write record as an output line. text is the client name, or the error name for event 13;
+// a kRawLine record has no line of its own and is not written.
+void writeRecord(const OutputRecord &record, std::string_view text, OutputSink &sink);
+// True when line is exactly what writeRecord prints for the event, so it need not be kept.
+bool isCanonicalLine(std::string_view line, int time, int eventId, std::string_view name, int table);
+
+// What a club day prints. The records a mode does not print are never stored.
+enum class OutputMode : uint8_t {
+    Full,        // open time, every event, close time and the report
+    ReportOnly,  // the report lines only
+    ErrorsOnly,  // the events 13 only
+    Summary,     // one "total <revenue> <occupied time>" line
 };
 
 class Club {
 public:
-    Club(int tablesnum, int openTime, int closeTime, int hourlyCost);
+    // names: interning table shared with the parser, so EventData::clientId can be used
+    // as is. Without it the club interns EventData::ClientName into its own table.
+    // memory: where the state of the day is allocated, e.g. an arena released after the
+    // day (see DayArena). It must outlive the club.
+    Club(int tablesnum, int openTime, int closeTime, int hourlyCost, ClientNames *names = nullptr,
+         std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    // names only read, e.g. shared by clubs on other threads: every event must come with
+    // its client id, and nothing that interns a name (the other processEvent overloads,
+    // restoreCheckpoint) may be called.
+    Club(int tablesnum, int openTime, int closeTime, int hourlyCost, const ClientNames *names,
+         std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    // Count events, errors, peaks and table turnovers into stats; nullptr turns it off.
+    void setStats(RunStats *stats);
+    // Set before the first event; Full by default.
+    void setOutputMode(OutputMode mode) { m_outputMode = mode; }
+    OutputMode outputMode() const { return m_outputMode; }
+    // Keep every (table, client, start, end) session for sessions(); off by default.
+    void recordSessions(bool enabled = true);
+    // Index over the recorded sessions and the tables taken right now (with an open end).
+    // Rebuilt on the first call after a change, so query in batches between events.
+    const SessionIndex &sessions() const;
+    // Sessions that ended so far, in the order they ended
+    const std::pmr::vector<Session> &recordedSessions() const { return m_sessions; }
+    std::string_view clientName(ClientId client) const { return names().name(client); }
     void processEvent(const EventData &event);
+    // Same for an event parsed in place; its client name is always interned.
+    void processEvent(const EventView &event);
+    // Same with the client id already known: it must come from the names table
+    // given to the constructor. An empty event.line is echoed in canonical form.
+    void processEvent(const EventView &event, ClientId client);
     void endOfDay();
+    // Output rendered as text; prefer writeOutput() or getRecords() to avoid keeping strings
     const std::vector<std::string>& getOutput() const;
+    const std::pmr::vector<OutputRecord>& getRecords() const { return m_outputRecords; }
+    // Echoed line of a record with eventId == OutputRecord::kRawLine
+    std::string_view rawLine(const OutputRecord &record) const { return m_rawLines[record.value]; }
+    const std::pmr::vector<Table>& getTables() const { return m_tables; }
     std::vector<std::string> getReport() const;
+    // Same lines as getOutput() and getReport(), written into sink
+    void writeOutput(OutputSink &sink) const;
+    // Only the output lines from record number first on, e.g. the ones added since the last call
+    void writeOutput(OutputSink &sink, size_t first) const;
+    void writeReport(OutputSink &sink) const;
+    // Total revenue and occupied time of every table as one "total" line
+    void writeSummary(OutputSink &sink) const;
     std::string getOpenTimeStr() const;
     std::string getCloseTimeStr() const;
+    // Number of events applied so far
+    size_t eventsProcessed() const { return m_eventsProcessed; }
+    int busyTables() const { return m_tablesCount - m_freeTables.count(); }
+    size_t waitingClients() const { return m_waitingQueue.size(); }
+    // Revenue of the sessions that ended so far
+    long long revenue() const;
+    // Drop the output records, e.g. once they were written, so a club that lives
+    // long does not keep its whole output. Record numbers start again from 0.
+    void discardOutput();
+
+    // Append a versioned binary checkpoint of the club state to data: tables with their
+    // revenue and occupied time, clients in the club, the waiting queue order and the
+    // client names. The output written so far is not included. O(state), not O(events).
+    void saveCheckpoint(std::string &data) const;
+    // Replace the state with a checkpoint of a club with the same configuration.
+    // Client names are interned again, so the ids may differ from the saved ones.
+    // Returns false and keeps the state if data is not such a checkpoint.
+    bool restoreCheckpoint(std::string_view data);
+    // Configuration of the club a checkpoint was taken from
+    static bool checkpointConfig(std::string_view data, ClubConfig &config);
 private:
     int m_tablesCount;
     int m_openTime;
     int m_closeTime;
     int m_hourlyCost;
-    std::vector<Table> m_tables;
-    std::set<std::string> m_currentClients;
-    std::unordered_map<std::string, int> m_seatedClients;
-    std::vector<std::string> m_waitingQueue;
-    std::vector<std::string> m_outputEvents;
-
-    void addOutputEvent(const std::string &event);
-    void processErrorEvent(int time, const std::string &errorMsg);
+    std::pmr::memory_resource *m_memory;
+    std::pmr::vector<Table> m_tables;
+    FreeTables m_freeTables;
+    ClientNames *m_sharedNames;   // interned into when set
+    const ClientNames *m_names;   // the table read: shared, read-only or m_ownNames
+    ClientNames m_ownNames;
+    std::pmr::vector<ClientState> m_clients;
+    WaitingQueue m_waitingQueue;
+    std::pmr::vector<OutputRecord> m_outputRecords;
+    // Echoed lines that differ from their canonical form, e.g. with extra spaces
+    std::pmr::vector<std::pmr::string> m_rawLines;
+    mutable std::vector<std::string> m_renderedOutput;
+    size_t m_eventsProcessed = 0;
+    RunStats *m_stats = nullptr;
+    OutputMode m_outputMode = OutputMode::Full;
+    bool m_recordSessions = false;
+    std::pmr::vector<Session> m_sessions;
+    mutable SessionIndex m_sessionIndex;
+    mutable bool m_sessionIndexStale = true;
+
+    const ClientNames &names() const { return *m_names; }
+    ClientNames &writableNames();
+    ClientId clientIdOf(const EventData &event);
+    ClientId internClient(std::string_view name);
+
+    void applyEvent(const EventView &event, ClientId client);
+    void addOutputEvent(int time, int eventId, ClientId client, int value = 0);
+    void addInputEcho(const EventView &event, ClientId client);
+    void renderRecord(const OutputRecord &record, OutputSink &sink) const;
+    void processErrorEvent(int time, ClubError error);
     int computeClientRevenue(int minutes) const;
     void freeTable(int tableIndex, int eventTime);
     void assignTableToWaiting(int tableIndex, int eventTime);
 
-    void processEventID1(int time, const std::string &client);
-    void processEventID2(int time, const std::string &client, int tableNumber);
-    void processEventID3(int time, const std::string &client);
-    void processEventID4(int time, const std::string &client);
+    void processEventID1(int time, ClientId client);
+    void processEventID2(int time, ClientId client, int tableNumber);
+    void processEventID3(int time, ClientId client);
+    void processEventID4(int time, ClientId client);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "DayArena.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace Yadro {
+
+DayArena::DayArena(size_t initialBytes, size_t maxBytes, std::pmr::memory_resource *upstream)
+    : m_capacity(initialBytes), m_maxBytes(std::max(initialBytes, maxBytes)), m_overflow(upstream),
+      m_block(static_cast<std::byte *>(upstream->allocate(initialBytes))) {
+    m_arena.emplace(m_block, m_capacity, &m_overflow);
+}
+
+DayArena::~DayArena() {
+    m_arena.reset();
+    m_overflow.upstream()->deallocate(m_block, m_capacity);
+}
+
+void DayArena::reset() {
+    // Destroying the arena gives the overflow blocks back upstream.
+    m_arena.reset();
+    if (m_overflow.bytes > 0 && m_capacity < m_maxBytes) {
+        m_overflow.upstream()->deallocate(m_block, m_capacity);
+        m_capacity = std::min(std::bit_ceil(m_capacity + m_overflow.bytes), m_maxBytes);
+        m_block = static_cast<std::byte *>(m_overflow.upstream()->allocate(m_capacity));
+    }
+    m_overflow.bytes = 0;
+    m_arena.emplace(m_block, m_capacity, &m_overflow);
+}
+
+void *DayArena::Overflow::do_allocate(size_t bytes, size_t alignment) {
+    this->bytes += bytes;
+    return m_upstream->allocate(bytes, alignment);
+}
+
+void DayArena::Overflow::do_deallocate(void *pointer, size_t bytes, size_t alignment) {
+    m_upstream->deallocate(pointer, bytes, alignment);
+}
+
+}
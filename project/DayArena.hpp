@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace Yadro {
+
+// Monotonic arena for the state of one club day: pass resource() to the Parser and
+// the Club of the day and call reset() once both are gone, which drops everything
+// at once. The first block is kept between days and grows to fit the largest day
+// seen (up to maxBytes), so a worker running day after day stops calling malloc.
+// Not thread-safe: one arena per thread.
+class DayArena {
+public:
+    static constexpr size_t kInitialBytes = 1 << 20;
+    static constexpr size_t kMaxBytes = 256 << 20;
+
+    // upstream: where the block and the overflow of a day are allocated
+    explicit DayArena(size_t initialBytes = kInitialBytes, size_t maxBytes = kMaxBytes,
+                      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+    DayArena(const DayArena &) = delete;
+    DayArena &operator=(const DayArena &) = delete;
+    ~DayArena();
+
+    std::pmr::memory_resource *resource() { return &*m_arena; }
+    // Release everything allocated since the last reset.
+    void reset();
+    // Size of the block reused for every day
+    size_t capacity() const { return m_capacity; }
+private:
+    // Upstream of the arena, counting what the day took beyond the block
+    class Overflow : public std::pmr::memory_resource {
+    public:
+        explicit Overflow(std::pmr::memory_resource *upstream) : m_upstream(upstream) {}
+        std::pmr::memory_resource *upstream() const { return m_upstream; }
+        size_t bytes = 0;
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+        std::pmr::memory_resource *m_upstream;
+    };
+
+    size_t m_capacity;
+    size_t m_maxBytes;
+    Overflow m_overflow;
+    std::byte *m_block;
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+};
+
+}
@@ -0,0 +1,171 @@
+#include "EventLog.hpp"
+#include "Club.hpp"
+#include "MappedFile.hpp"
+#include "Parser.hpp"
+#include "Runner.hpp"
+#include <climits>
+
+namespace Yadro {
+
+namespace EventLog {
+
+namespace {
+
+constexpr std::string_view kMagic = "YEVL";
+constexpr uint8_t kVersion = 1;
+
+void putVarint(OutputSink &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.appendChar(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.appendChar(static_cast<char>(value));
+}
+
+void putBytes(OutputSink &out, std::string_view bytes) {
+    putVarint(out, bytes.size());
+    out.append(bytes);
+}
+
+// Bounds-checked decoding of the mapped log.
+class Reader {
+public:
+    explicit Reader(std::string_view data) : m_data(data) {}
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos >= m_data.size(); }
+
+    uint8_t byte() {
+        if (m_pos >= m_data.size()) {
+            m_ok = false;
+            return 0;
+        }
+        return static_cast<uint8_t>(m_data[m_pos++]);
+    }
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_pos >= m_data.size())
+                break;
+            uint8_t next = static_cast<uint8_t>(m_data[m_pos++]);
+            value |= static_cast<uint64_t>(next & 0x7F) << shift;
+            if ((next & 0x80) == 0)
+                return value;
+        }
+        m_ok = false;
+        return 0;
+    }
+    std::string_view bytes() {
+        uint64_t length = varint();
+        if (!m_ok || length > m_data.size() - m_pos) {
+            m_ok = false;
+            return {};
+        }
+        std::string_view result = m_data.substr(m_pos, length);
+        m_pos += length;
+        return result;
+    }
+private:
+    std::string_view m_data;
+    size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+}
+
+bool convert(const std::string &textFile, OutputSink &out, std::string &errorLine) {
+    Parser parser(textFile);
+    ClubConfig config;
+    if (!parser.ReadConfig(config, errorLine))
+        return false;
+    out.append(kMagic).appendChar(static_cast<char>(kVersion));
+    putVarint(out, config.numTables);
+    putVarint(out, config.openTime);
+    putVarint(out, config.closeTime);
+    putVarint(out, config.hourlyCost);
+
+    // The parser interns the names in order, so a new name always gets the next id.
+    ClientId namesWritten = 0;
+    EventData event;
+    while (parser.NextEvent(event, errorLine)) {
+        bool newName = event.clientId == namesWritten;
+        bool raw = !isCanonicalLine(event.originalLine, event.time, event.eventId, event.ClientName, event.TableNumber);
+        out.appendChar(static_cast<char>(event.eventId | (newName ? kNewName : 0) | (raw ? kRawLine : 0)));
+        putVarint(out, event.time);
+        if (newName) {
+            putBytes(out, event.ClientName);
+            namesWritten++;
+        } else {
+            putVarint(out, event.clientId);
+        }
+        if (event.eventId == 2)
+            putVarint(out, event.TableNumber);
+        if (raw)
+            putBytes(out, event.originalLine);
+        out.endLine();
+    }
+    return !parser.Failed();
+}
+
+bool replay(const std::string &logFile, OutputSink &out, std::string &error) {
+    MappedFile file;
+    if (!file.open(logFile)) {
+        error = "Error: Cannot open file " + logFile;
+        return false;
+    }
+    Reader reader(file.data());
+    error = "Error: Bad event log " + logFile;
+    for (char c : kMagic) {
+        if (reader.byte() != static_cast<uint8_t>(c))
+            return false;
+    }
+    if (reader.byte() != kVersion)
+        return false;
+    // Range-checked before the casts, so a damaged value cannot wrap into a valid one.
+    uint64_t tables = reader.varint();
+    uint64_t openTime = reader.varint();
+    uint64_t closeTime = reader.varint();
+    uint64_t cost = reader.varint();
+    if (!reader.ok() || tables == 0 || tables > INT_MAX || cost == 0 || cost > INT_MAX || openTime >= closeTime
+        || closeTime >= 24 * 60)
+        return false;
+    ClubConfig config;
+    config.numTables = static_cast<int>(tables);
+    config.openTime = static_cast<int>(openTime);
+    config.closeTime = static_cast<int>(closeTime);
+    config.hourlyCost = static_cast<int>(cost);
+
+    ClientNames names;
+    Club club(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &names);
+    while (!reader.atEnd()) {
+        uint8_t head = reader.byte();
+        EventView event{};
+        event.eventId = head & kEventIdMask;
+        uint64_t time = reader.varint();
+        ClientId client;
+        if (head & kNewName) {
+            client = names.intern(reader.bytes());
+        } else {
+            uint64_t id = reader.varint();
+            if (id >= names.size())
+                return false;
+            client = static_cast<ClientId>(id);
+        }
+        uint64_t table = event.eventId == 2 ? reader.varint() : 0;
+        if (head & kRawLine)
+            event.line = reader.bytes();
+        // Records are separated by a newline, which also catches a misaligned read.
+        if (!reader.ok() || reader.byte() != '\n' || event.eventId < 1 || event.eventId > 4 || time >= 24 * 60
+            || (event.eventId == 2 && (table < 1 || table > tables)))
+            return false;
+        event.time = static_cast<int>(time);
+        event.tableNumber = event.eventId == 2 ? static_cast<int>(table) : -1;
+        club.processEvent(event, client);
+    }
+    error.clear();
+    finishClubDay(club, out);
+    return true;
+}
+
+}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "OutputSink.hpp"
+#include <string>
+
+namespace Yadro {
+
+// Binary event log: a compact form of a checked input file that is replayed
+// without tokenizing. Layout (varints are unsigned LEB128):
+//   "YEVL", version byte, varints: tables count, open time, close time, hourly cost,
+//   then one record per event:
+//     byte:   event id (1-4) | kNewName | kRawLine
+//     varint: time in minutes
+//     kNewName: varint length and the name bytes, the name gets the next id;
+//     otherwise: varint client id
+//     event 2: varint table number
+//     kRawLine: varint length and the original line, kept only when it differs
+//               from the canonical "HH:MM id name [table]"
+//     '\n' ending the record
+namespace EventLog {
+
+constexpr uint8_t kNewName = 0x80;
+constexpr uint8_t kRawLine = 0x40;
+constexpr uint8_t kEventIdMask = 0x0F;
+
+// Check a text input file with the usual parser and write it to out as a binary log.
+// On a bad input errorLine is what the file mode would print.
+bool convert(const std::string &textFile, OutputSink &out, std::string &errorLine);
+
+// Run one club day from a binary log and write the same output as runClubFile
+// for the text file it was converted from. False with error set if the log is damaged.
+bool replay(const std::string &logFile, OutputSink &out, std::string &error);
+
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Yadro {
+
+// Set of free table indexes (0-based) as a bitset with a running count:
+// "is any table free" is O(1), "lowest free table" is O(words).
+class FreeTables {
+public:
+    explicit FreeTables(int tablesCount = 0, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+        : m_words((tablesCount + 63) / 64, ~uint64_t(0), memory), m_count(tablesCount) {
+        if (tablesCount % 64 != 0)
+            m_words.back() = (uint64_t(1) << (tablesCount % 64)) - 1;
+    }
+
+    bool any() const { return m_count > 0; }
+    int count() const { return m_count; }
+
+    bool isFree(int index) const { return (m_words[index / 64] >> (index % 64)) & 1; }
+
+    void markFree(int index) {
+        uint64_t bit = uint64_t(1) << (index % 64);
+        if (!(m_words[index / 64] & bit)) {
+            m_words[index / 64] |= bit;
+            m_count++;
+        }
+    }
+
+    void markBusy(int index) {
+        uint64_t bit = uint64_t(1) << (index % 64);
+        if (m_words[index / 64] & bit) {
+            m_words[index / 64] &= ~bit;
+            m_count--;
+        }
+    }
+
+    // Lowest free table index, or -1 if every table is busy.
+    int lowest() const {
+        if (m_count == 0)
+            return -1;
+        for (size_t word = 0; word < m_words.size(); word++) {
+            if (m_words[word] != 0)
+                return static_cast<int>(word * 64) + std::countr_zero(m_words[word]);
+        }
+        return -1;
+    }
+private:
+    std::pmr::vector<uint64_t> m_words;
+    int m_count;
+};
+
+}
@@ -0,0 +1,104 @@
+#include "Library.hpp"
+#include "ParserHelpers.hpp"
+#include "Runner.hpp"
+#include "OutputSink.hpp"
+
+namespace Yadro {
+
+namespace {
+
+DayResult rejectedDay(std::string_view errorLine) {
+    DayResult result;
+    result.errorLine = errorLine;
+    result.text = result.errorLine + "\n";
+    return result;
+}
+
+DayResult finishedDay(Club &club, const ClubConfig &config) {
+    DayResult result;
+    result.accepted = true;
+    result.config = config;
+    MemorySink text;
+    finishClubDay(club, text);
+    result.text = text.data();
+
+    result.events.reserve(club.getRecords().size());
+    for (const auto &record : club.getRecords()) {
+        if (record.eventId == OutputRecord::kRawLine) {
+            // An echoed line kept as written; it was a valid event line.
+            EventView view{};
+            parseEvent(club.rawLine(record), view, config);
+            result.events.push_back({view.time, view.eventId, std::string(view.clientName),
+                                     view.eventId == 2 ? view.tableNumber : 0, {}});
+        } else if (record.eventId == 13) {
+            result.events.push_back({record.time, 13, {}, 0,
+                                     std::string(errorName(static_cast<ClubError>(record.value)))});
+        } else {
+            int table = record.eventId == 2 || record.eventId == 12 ? record.value : 0;
+            result.events.push_back({record.time, record.eventId, std::string(club.clientName(record.client)), table, {}});
+        }
+    }
+    result.tables.reserve(club.getTables().size());
+    for (const auto &table : club.getTables())
+        result.tables.push_back({table.number, table.revenue, table.totalOccupied});
+    return result;
+}
+
+}
+
+DayResult runDay(std::string_view input, OutputMode mode) {
+    Parser parser(Parser::InMemory{}, input);
+    ClubConfig config;
+    std::string errorLine;
+    if (!parser.ReadConfig(config, errorLine))
+        return rejectedDay(errorLine);
+    Club club(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &parser.names());
+    club.setOutputMode(mode);
+    EventView event;
+    while (parser.NextEvent(event, errorLine))
+        club.processEvent(event);
+    if (parser.Failed())
+        return rejectedDay(errorLine);
+    return finishedDay(club, config);
+}
+
+DayStream::DayStream(OutputMode mode) : m_mode(mode) {
+    m_state.setNames(&m_names);
+}
+
+DayStream::~DayStream() = default;
+
+bool DayStream::feed(std::string_view data) {
+    if (!m_rejected)
+        m_lines.feed(data, [this](std::string_view line) { return feedLine(line); });
+    return !m_rejected;
+}
+
+bool DayStream::feedLine(std::string_view line) {
+    while (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    EventData event;
+    LineParser::Result result = m_state.feed(line, event, m_errorLine);
+    if (result == LineParser::Result::Error) {
+        m_rejected = true;
+    } else if (result == LineParser::Result::Config) {
+        const ClubConfig &config = m_state.config();
+        m_club = std::make_unique<Club>(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &m_names);
+        m_club->setOutputMode(m_mode);
+    } else if (result == LineParser::Result::Event) {
+        m_club->processEvent(event);
+    }
+    return !m_rejected;
+}
+
+DayResult DayStream::finish() {
+    if (!m_rejected)
+        m_lines.finish([this](std::string_view line) { return feedLine(line); });
+    if (!m_rejected && !m_state.finish(m_errorLine))
+        m_rejected = true;
+    if (m_rejected)
+        return rejectedDay(m_errorLine);
+    return finishedDay(*m_club, m_state.config());
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// Embedding API of libyadro: run club days from memory instead of a file and a
+// process per day. See yadro.h for the same from C.
+
+#include "Parser.hpp"
+#include "Club.hpp"
+#include "LineSplitter.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Yadro {
+
+// One line of the club output, as fields
+struct DayEvent {
+    int time;
+    int eventId;           // 1-4 input event, 11-13 generated event
+    std::string client;    // empty for event 13
+    int table;             // events 2 and 12, 0 otherwise
+    std::string error;     // event 13 only
+};
+
+struct DayTable {
+    int number;
+    int revenue;
+    int occupied;          // minutes
+};
+
+struct DayResult {
+    bool accepted = false;
+    std::string errorLine;         // first bad line of a rejected input
+    ClubConfig config{};
+    std::vector<DayEvent> events;  // the events the output mode keeps
+    std::vector<DayTable> tables;
+    std::string text;              // the output exactly as main prints it
+};
+
+// Run a club day from the whole text of an input file.
+DayResult runDay(std::string_view input, OutputMode mode = OutputMode::Full);
+
+// Club day fed by pieces of the input as they arrive; lines may be split across
+// pieces. Each event is applied as soon as its line is complete.
+class DayStream {
+public:
+    explicit DayStream(OutputMode mode = OutputMode::Full);
+    ~DayStream();
+    DayStream(const DayStream &) = delete;
+    DayStream &operator=(const DayStream &) = delete;
+
+    // Returns false once the input was rejected; the rest is then ignored.
+    bool feed(std::string_view data);
+    // End of input: close the day and return its result. Call once.
+    DayResult finish();
+private:
+    OutputMode m_mode;
+    ClientNames m_names;
+    LineParser m_state;
+    std::unique_ptr<Club> m_club;
+    LineSplitter m_lines;
+    std::string m_errorLine;
+    bool m_rejected = false;
+
+    bool feedLine(std::string_view line);  // false once the input is rejected
+};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Yadro {
+
+// Cuts input that comes in pieces (reads of a pipe or a socket, chunks fed by a caller)
+// into lines without their '\n'. A line split across pieces is kept until its end comes;
+// the others are passed on as views into the piece.
+class LineSplitter {
+public:
+    // Call onLine for every line data completes. onLine returns false to stop: the rest
+    // of data is dropped and feed returns false.
+    template <typename OnLine>
+    bool feed(std::string_view data, OnLine &&onLine) {
+        size_t end;
+        while ((end = data.find('\n')) != std::string_view::npos) {
+            bool more;
+            if (m_pending.empty()) {
+                more = onLine(data.substr(0, end));
+            } else {
+                m_pending.append(data.substr(0, end));
+                more = onLine(std::string_view(m_pending));
+                m_pending.clear();
+            }
+            if (!more)
+                return false;
+            data.remove_prefix(end + 1);
+        }
+        m_pending.append(data);
+        return true;
+    }
+
+    // End of input: call onLine for the last line if it has no '\n'.
+    template <typename OnLine>
+    bool finish(OnLine &&onLine) {
+        if (m_pending.empty())
+            return true;
+        std::string line = std::move(m_pending);
+        m_pending.clear();
+        return onLine(std::string_view(line));
+    }
+
+    // Length of the line not complete yet
+    size_t pendingSize() const { return m_pending.size(); }
+private:
+    std::string m_pending;
+};
+
+}
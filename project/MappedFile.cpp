@@ -0,0 +1,50 @@
+#include "MappedFile.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Yadro {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (m_mapping != nullptr)
+        munmap(m_mapping, m_mappedSize);
+    m_mapping = nullptr;
+    m_mappedSize = 0;
+    m_buffer.clear();
+    m_data = {};
+}
+
+bool MappedFile::open(const std::string &filename) {
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        if (info.st_size > 0) {
+            void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+                m_mapping = mapping;
+                m_mappedSize = info.st_size;
+                m_data = std::string_view(static_cast<const char *>(mapping), m_mappedSize);
+            }
+        }
+        ::close(fd);
+        return info.st_size == 0 || m_mapping != nullptr;
+    }
+    char chunk[65536];
+    ssize_t count;
+    while ((count = ::read(fd, chunk, sizeof(chunk))) > 0)
+        m_buffer.append(chunk, count);
+    ::close(fd);
+    m_data = m_buffer;
+    return count == 0;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Yadro {
+
+// Read-only view of a whole file. Regular files are mapped with mmap, so reading the
+// data costs no copies; other inputs (pipes, character devices) are read into memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &filename);
+    std::string_view data() const { return m_data; }
+private:
+    void *m_mapping = nullptr;
+    size_t m_mappedSize = 0;
+    std::string m_buffer; // used only when the input cannot be mapped
+    std::string_view m_data;
+
+    void close();
+};
+
+}
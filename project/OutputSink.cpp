@@ -0,0 +1,49 @@
+#include "OutputSink.hpp"
+#include "Time.hpp"
+#include <charconv>
+#include <cerrno>
+#include <unistd.h>
+
+namespace Yadro {
+
+OutputSink &OutputSink::appendInt(long long value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    m_buffer.append(digits, result.ptr);
+    return *this;
+}
+
+OutputSink &OutputSink::appendTime(int totalMinutes) {
+    char text[Time::kMaxLength];
+    m_buffer.append(text, Time::Format(totalMinutes, text));
+    return *this;
+}
+
+void FdSink::flush() {
+    size_t written = 0;
+    while (m_good && written < m_buffer.size()) {
+        ssize_t count = ::write(m_fd, m_buffer.data() + written, m_buffer.size() - written);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            m_good = false;
+        else
+            written += count;
+    }
+    m_buffer.clear();
+}
+
+std::vector<std::string> MemorySink::lines() const {
+    std::vector<std::string> result;
+    size_t pos = 0;
+    while (pos < m_buffer.size()) {
+        size_t end = m_buffer.find('\n', pos);
+        if (end == std::string::npos)
+            end = m_buffer.size();
+        result.emplace_back(m_buffer, pos, end - pos);
+        pos = end + 1;
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Yadro {
+
+// Append-only output buffer. Lines are formatted straight into the buffer with
+// no temporary strings; flush() hands the collected bytes to the destination.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    OutputSink &append(std::string_view text) {
+        m_buffer.append(text);
+        return *this;
+    }
+    OutputSink &appendChar(char c) {
+        m_buffer.push_back(c);
+        return *this;
+    }
+    OutputSink &appendInt(long long value);
+    // Minutes as "HH:MM"
+    OutputSink &appendTime(int totalMinutes);
+
+    // Finish the current line, flushing once enough bytes have collected.
+    void endLine() {
+        m_buffer.push_back('\n');
+        if (m_buffer.size() >= kFlushThreshold)
+            flush();
+    }
+    void line(std::string_view text) {
+        append(text);
+        endLine();
+    }
+
+    virtual void flush() = 0;
+protected:
+    static constexpr size_t kFlushThreshold = 1 << 16;
+    std::string m_buffer;
+};
+
+// Writes to a file descriptor with large write(2) calls.
+class FdSink : public OutputSink {
+public:
+    explicit FdSink(int fd) : m_fd(fd) {}
+    ~FdSink() override { flush(); }
+    FdSink(const FdSink &) = delete;
+    FdSink &operator=(const FdSink &) = delete;
+
+    void flush() override;
+    // False if a write to the descriptor has failed
+    bool good() const { return m_good; }
+private:
+    int m_fd;
+    bool m_good = true;
+};
+
+// Keeps everything in memory, e.g. for tests.
+class MemorySink : public OutputSink {
+public:
+    void flush() override {}
+    std::string_view data() const { return m_buffer; }
+    std::vector<std::string> lines() const;
+    void clear() { m_buffer.clear(); }
+};
+
+}
@@ -1,56 +1,219 @@
 #include "Parser.hpp"
 #include "Time.hpp"
 #include "ParserHelpers.hpp"
-#include <fstream>
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 namespace Yadro {
 
-bool Parser::readLines(const std::string &filename, std::string &errorLine) {
-    std::ifstream fileStream(filename);
-    if (!fileStream) {
-        errorLine = "Error: Cannot open file " + filename;
-        return false;
-    }
-    std::string line;
-    while (std::getline(fileStream, line)) {
-        while (!line.empty() && (line.back() == '\r'))
-            line.pop_back();
-        m_lines.push_back(line);
+namespace {
+
+// Newline-aligned part of the input and the result of parsing it.
+struct Chunk {
+    std::string_view text;
+    std::vector<EventView> events;
+    std::string_view badLine;  // first bad line of the chunk
+    bool failed = false;
+    bool ready = false;
+};
+
+void parseChunk(Chunk &chunk, const ClubConfig &config) {
+    std::string_view text = chunk.text;
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        while (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+        EventView event;
+        if (!parseEvent(line, event, config)) {
+            chunk.badLine = line;
+            chunk.failed = true;
+            return;
+        }
+        chunk.events.push_back(event);
     }
-    return true;
 }
 
-Parser::Parser(const std::string &filename) {
-    std::string err;
-    if (!readLines(filename, err)) {
-        m_lines.push_back(err);
+}
+
+LineParser::Result LineParser::feed(std::string_view line, EventData &event, std::string &errorLine) {
+    if (!m_configured) {
+        m_configLines.emplace_back(line);
+        if (m_configLines.size() < 3)
+            return Result::None;
+        if (!parseTableCount(m_configLines[0], m_config, errorLine))
+            return Result::Error;
+        if (!parseOperatingHours(m_configLines[1], m_config, errorLine))
+            return Result::Error;
+        if (!parseHourlyCost(m_configLines[2], m_config, errorLine))
+            return Result::Error;
+        m_configLines.clear();
+        m_configured = true;
+        return Result::Config;
     }
+    if (line.empty())
+        return Result::None;
+    if (!parseEvent(line, event, m_config, errorLine))
+        return Result::Error;
+    if (m_names != nullptr)
+        event.clientId = m_names->intern(event.ClientName);
+    return Result::Event;
 }
 
-bool Parser::ExecuteLines(ClubConfig &config, std::vector<EventData> &events, std::string & errorLine) {
-    int lineNum = 0;
-    if (m_lines.size() < 3) {
+bool LineParser::finish(std::string &errorLine) const {
+    if (!m_configured) {
         errorLine = "Not enough configuration lines provided.\nMust be:\n<Number of Tables>\n<Opening Hours> <Closing Hours>\n<Hourly Cost>.";
         return false;
     }
+    return true;
+}
 
-    if (!parseTableCount(m_lines[lineNum++], config, errorLine))
-        return false;
-    if (!parseOperatingHours(m_lines[lineNum++], config, errorLine))
+Parser::Parser(const std::string &filename, std::pmr::memory_resource *memory) : m_names(memory) {
+    m_state.setNames(&m_names);
+    // A file that cannot be opened reads as empty and is reported as missing config lines.
+    if (m_file.open(filename))
+        m_data = m_file.data();
+}
+
+Parser::Parser(InMemory, std::string_view text, std::pmr::memory_resource *memory) : m_names(memory), m_data(text) {
+    m_state.setNames(&m_names);
+}
+
+bool Parser::readLine() {
+    if (m_pos >= m_data.size())
         return false;
-    if (!parseHourlyCost(m_lines[lineNum++], config, errorLine))
+    size_t end = m_data.find('\n', m_pos);
+    if (end == std::string_view::npos)
+        end = m_data.size();
+    m_line = m_data.substr(m_pos, end - m_pos);
+    m_pos = end + 1;
+    while (!m_line.empty() && (m_line.back() == '\r'))
+        m_line.remove_suffix(1);
+    return true;
+}
+
+bool Parser::ReadConfig(ClubConfig &config, std::string &errorLine) {
+    EventData unused;
+    while (!m_state.configured()) {
+        if (!readLine()) {
+            m_failed = !m_state.finish(errorLine);
+            return false;
+        }
+        if (m_state.feed(m_line, unused, errorLine) == LineParser::Result::Error) {
+            m_failed = true;
+            return false;
+        }
+    }
+    config = m_state.config();
+    return true;
+}
+
+bool Parser::NextEvent(EventData &event, std::string &errorLine) {
+    if (m_failed)
         return false;
+    while (readLine()) {
+        LineParser::Result result = m_state.feed(m_line, event, errorLine);
+        if (result == LineParser::Result::Event)
+            return true;
+        if (result == LineParser::Result::Error) {
+            m_failed = true;
+            return false;
+        }
+    }
+    m_failed = !m_state.finish(errorLine);
+    return false;
+}
 
-    for (; lineNum < static_cast<int>(m_lines.size()); lineNum++) {
-        std::string line = m_lines[lineNum];
-        if (line.empty())
+bool Parser::NextEvent(EventView &event, std::string &errorLine) {
+    if (m_failed || !m_state.configured())
+        return false;
+    while (readLine()) {
+        if (m_line.empty())
             continue;
-        EventData event;
-        if (!parseEvent(line, event, config, errorLine))
+        if (!parseEvent(m_line, event, m_state.config())) {
+            errorLine = m_line;
+            m_failed = true;
             return false;
-        events.push_back(event);
+        }
+        return true;
     }
-    return true;
+    return false;
 }
 
-}
\ No newline at end of file
+bool Parser::ParseChunks(ThreadPool &pool, const ChunkConsumer &consume, std::string &errorLine, size_t chunkSize) {
+    if (m_failed || !m_state.configured())
+        return false;
+    std::string_view rest = m_data.substr(std::min(m_pos, m_data.size()));
+    m_pos = m_data.size();
+    const ClubConfig config = m_state.config();
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    // Only a window of chunks is parsed ahead of the consumer, so memory does not grow with the file.
+    std::vector<Chunk> window(2 * pool.size() + 1);
+    std::mutex mutex;
+    std::condition_variable parsed;
+    size_t offset = 0;
+    size_t submitted = 0;
+    auto submitNext = [&]() {
+        if (offset >= rest.size())
+            return false;
+        size_t end = rest.size();
+        if (rest.size() - offset > chunkSize) {
+            end = rest.find('\n', offset + chunkSize - 1);
+            end = end == std::string_view::npos ? rest.size() : end + 1;
+        }
+        Chunk &chunk = window[submitted % window.size()];
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk.text = rest.substr(offset, end - offset);
+            chunk.events.clear();
+            chunk.failed = false;
+            chunk.ready = false;
+        }
+        offset = end;
+        submitted++;
+        pool.submit([&chunk, &config, &mutex, &parsed] {
+            parseChunk(chunk, config);
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk.ready = true;
+            parsed.notify_all();
+        });
+        return true;
+    };
+
+    while (submitted < window.size() && submitNext()) {}
+    for (size_t next = 0; next < submitted; next++) {
+        Chunk &chunk = window[next % window.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            parsed.wait(lock, [&chunk] { return chunk.ready; });
+        }
+        if (chunk.failed) {
+            // All the earlier chunks were clean, so this is the lowest bad line.
+            errorLine = chunk.badLine;
+            m_failed = true;
+            break;
+        }
+        consume(chunk.events);
+        submitNext();
+    }
+    // The tasks still running refer to the window.
+    pool.wait();
+    return !m_failed;
+}
+
+bool Parser::ExecuteLines(ClubConfig &config, std::vector<EventData> &events, std::string & errorLine) {
+    if (!ReadConfig(config, errorLine))
+        return false;
+    EventData event;
+    while (NextEvent(event, errorLine))
+        events.push_back(event);
+    return !m_failed;
+}
+
+}
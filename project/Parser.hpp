@@ -1,7 +1,12 @@
 #pragma once
 
+#include <functional>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "MappedFile.hpp"
+#include "ClientNames.hpp"
 
 namespace Yadro {
 
@@ -18,19 +23,92 @@ struct EventData {
     std::string ClientName;
     int TableNumber;
     std::string originalLine;
+    ClientId clientId = kNoClient; // set when the parser interns names
 };
 
+// Event line parsed in place: the views point into the input text.
+struct EventView {
+    int time;
+    int eventId;
+    int tableNumber;              // -1 unless eventId == 2
+    std::string_view clientName;
+    std::string_view line;        // the whole original line
+};
+
+class ThreadPool;
+
+// Line-by-line parsing state: the first 3 lines are the config, the rest are events.
+// Holds no more than the 3 config lines, so it can be fed from any source.
+class LineParser {
+public:
+    enum class Result { None, Config, Event, Error };
+    // Feed the next input line. Config is reported once all 3 config lines are valid,
+    // Event when the line was parsed into event, None for lines that produce nothing yet.
+    Result feed(std::string_view line, EventData &event, std::string &errorLine);
+    // Call at the end of input: fails if the config lines were not complete.
+    bool finish(std::string &errorLine) const;
+    const ClubConfig &config() const { return m_config; }
+    bool configured() const { return m_configured; }
+    // Skip the config lines: the next lines fed are events of a club with config.
+    void configure(const ClubConfig &config) {
+        m_config = config;
+        m_configLines.clear();
+        m_configured = true;
+    }
+    // Intern client names of parsed events into names and fill EventData::clientId.
+    void setNames(ClientNames *names) { m_names = names; }
+private:
+    ClubConfig m_config{};
+    ClientNames *m_names = nullptr;
+    std::vector<std::string> m_configLines;
+    bool m_configured = false;
+};
 
 class Parser {
 public:
-    // Constructor: call readLines method
-    explicit Parser(const std::string &filename);
+    // Default size of a chunk in the parallel mode
+    static constexpr size_t kChunkSize = 1 << 20;
+    using ChunkConsumer = std::function<void(const std::vector<EventView> &events)>;
+
+    // Constructor: map the file, lines are tokenized in place on demand.
+    // The interned client names are allocated from memory.
+    explicit Parser(const std::string &filename, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    // Parse text already in memory instead of a file; text must outlive the Parser.
+    struct InMemory {};
+    Parser(InMemory, std::string_view text, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
     // Start parsing - check config lines (lines 1, 2, 3) and events lines (lines 4+)
     bool ExecuteLines(ClubConfig &config, std::vector<EventData> &events, std::string & errorLine);
+
+    // Streaming mode: read and check the config lines only.
+    bool ReadConfig(ClubConfig &config, std::string &errorLine);
+    // Streaming mode: parse the next event line. Returns false at the end of the file
+    // or on the first bad line, in which case Failed() is true and errorLine is set.
+    bool NextEvent(EventData &event, std::string &errorLine);
+    // Same after ReadConfig, with the event viewing into the mapped file instead of
+    // copying its line and name; the views stay valid while the Parser lives.
+    bool NextEvent(EventView &event, std::string &errorLine);
+    bool Failed() const { return m_failed; }
+    // Bytes of the input not read yet
+    size_t RemainingBytes() const { return m_pos < m_data.size() ? m_data.size() - m_pos : 0; }
+    // Parallel mode, after ReadConfig: split the rest of the file into newline-aligned
+    // chunks of about chunkSize bytes, parse them on pool and pass the events of each
+    // chunk to consume in file order. Views stay valid while the Parser lives.
+    // On a bad line no chunk from that one on is consumed, errorLine is the lowest
+    // bad line of the file and Failed() is true. Waits for every task of pool.
+    bool ParseChunks(ThreadPool &pool, const ChunkConsumer &consume, std::string &errorLine,
+                     size_t chunkSize = kChunkSize);
+    // Ids of the client names met so far; pass it to Club to share the ids.
+    ClientNames &names() { return m_names; }
 private:
-    std::vector<std::string> m_lines;
-    // Read lines from file and save to lines
-    bool readLines(const std::string &filename, std::string &errorLine);
+    MappedFile m_file;
+    ClientNames m_names;
+    std::string_view m_data;
+    size_t m_pos = 0;
+    std::string_view m_line;
+    LineParser m_state;
+    bool m_failed = false;
+    // Take the next line from the mapped data, without the trailing '\r'
+    bool readLine();
 };
 
 }
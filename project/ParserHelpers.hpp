@@ -1,14 +1,14 @@
 #pragma once
 
 #include <string>
-#include <vector>
+#include <string_view>
 #include "Parser.hpp"
 #include "Utils.hpp"
 #include "Time.hpp"
 
 namespace Yadro {
 
-inline bool parseTableCount(const std::string &line, ClubConfig &config, std::string &errorLine) {
+inline bool parseTableCount(std::string_view line, ClubConfig &config, std::string &errorLine) {
     auto tokens = Util::splitString(line);
     if (tokens.size() != 1) {
         errorLine = line;
@@ -27,7 +27,7 @@ inline bool parseTableCount(const std::string &line, ClubConfig &config, std::st
     return true;
 }
 
-inline bool parseOperatingHours(const std::string &line, ClubConfig &config, std::string &errorLine) {
+inline bool parseOperatingHours(std::string_view line, ClubConfig &config, std::string &errorLine) {
     auto tokens = Util::splitString(line);
     if (tokens.size() != 2) {
         errorLine = line;
@@ -52,7 +52,7 @@ inline bool parseOperatingHours(const std::string &line, ClubConfig &config, std
     return true;
 }
 
-inline bool parseHourlyCost(const std::string &line, ClubConfig &config, std::string &errorLine) {
+inline bool parseHourlyCost(std::string_view line, ClubConfig &config, std::string &errorLine) {
     auto tokens = Util::splitString(line);
     if (tokens.size() != 1) {
         errorLine = line;
@@ -71,51 +71,52 @@ inline bool parseHourlyCost(const std::string &line, ClubConfig &config, std::st
     return true;
 }
 
-inline bool parseEvent(const std::string &line, EventData &event, ClubConfig &config, std::string &errorLine) {
+// Check one event line and fill event with views into line; false if the line is bad.
+inline bool parseEvent(std::string_view line, EventView &event, const ClubConfig &config) {
     auto tokens = Util::splitString(line);
-    if (tokens.size() < 2) {
-        errorLine = line;
+    if (tokens.size() < 2)
         return false;
-    }
     auto maybeTime = Time::FromString(tokens[0]);
-    if (!maybeTime.has_value()) {
-        errorLine = line;
+    if (!maybeTime.has_value())
         return false;
-    }
     event.time = maybeTime.value();
     auto maybeEventId = Util::FromString(tokens[1]);
-    if (!maybeEventId.has_value()) {
-        errorLine = line;
+    if (!maybeEventId.has_value())
         return false;
-    }
     int eventId = maybeEventId.value();
-    if (eventId < 1 || eventId > 4) {
-        errorLine = line;
+    if (eventId < 1 || eventId > 4)
         return false;
-    }
 
     event.eventId = eventId;
     size_t expectedParams = (eventId == 2) ? 2 : 1;
-    if (tokens.size() != 2 + expectedParams) {
-        errorLine = line;
+    if (tokens.size() != 2 + expectedParams)
         return false;
-    }
-    event.originalLine = line;
-    event.TableNumber = -1;
-    event.ClientName = tokens[2];
+    event.line = line;
+    event.tableNumber = -1;
+    event.clientName = tokens[2];
     if (eventId == 2) {
         auto maybeTable = Util::FromString(tokens[3]);
-        if (!maybeTable.has_value()) {
-            errorLine = line;
+        if (!maybeTable.has_value())
             return false;
-        }
-        event.TableNumber = maybeTable.value();
-        if (event.TableNumber < 1 || event.TableNumber > config.numTables) {
-            errorLine = line;
+        event.tableNumber = maybeTable.value();
+        if (event.tableNumber < 1 || event.tableNumber > config.numTables)
             return false;
-        }
     }
     return true;
 }
 
+inline bool parseEvent(std::string_view line, EventData &event, ClubConfig &config, std::string &errorLine) {
+    EventView view;
+    if (!parseEvent(line, view, config)) {
+        errorLine = line;
+        return false;
+    }
+    event.time = view.time;
+    event.eventId = view.eventId;
+    event.originalLine = view.line;
+    event.TableNumber = view.tableNumber;
+    event.ClientName = view.clientName;
+    return true;
+}
+
 }
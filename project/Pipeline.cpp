@@ -0,0 +1,238 @@
+#include "Pipeline.hpp"
+#include "ParserHelpers.hpp"
+#include "MappedFile.hpp"
+#include "Parser.hpp"
+#include "SpscRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Yadro {
+
+namespace {
+
+constexpr size_t kRingSize = 4096;
+constexpr size_t kWritePiece = 1 << 20;
+
+enum class Verdict : uint8_t { Pending, Accepted, Rejected };
+
+// Reader -> parser: one input line without its newline
+struct LineRecord {
+    std::string_view text;
+    bool end;                 // no more lines
+};
+
+// Parser -> club
+struct EventRecord {
+    enum Kind : uint8_t { Config, Event, Reject, End };
+    Kind kind;
+    EventView event;          // Event
+    ClubConfig config;        // Config
+};
+
+// Club -> formatter
+struct OutputItem {
+    enum Kind : uint8_t { Record, Line, Text, Reject, End };
+    Kind kind;
+    OutputRecord record;      // Record
+    std::string_view text;    // client or error name of a Record, a Line without its
+                              // newline, Text as is, or the bad line of a Reject
+};
+
+class Pipeline {
+public:
+    Pipeline(std::string_view input, OutputMode mode)
+        : m_input(input), m_mode(mode), m_lines(std::make_unique<SpscRing<LineRecord, kRingSize>>()),
+          m_events(std::make_unique<SpscRing<EventRecord, kRingSize>>()),
+          m_output(std::make_unique<SpscRing<OutputItem, kRingSize>>()) {}
+
+    bool run(OutputSink &out) {
+        std::thread validator([this] { validate(); });
+        std::thread reader([this] { read(); });
+        std::thread parser([this] { parse(); });
+        std::thread club([this] { apply(); });
+        bool accepted = format(out);
+        validator.join();
+        reader.join();
+        parser.join();
+        club.join();
+        return accepted;
+    }
+private:
+    std::string_view m_input;
+    OutputMode m_mode;
+    std::unique_ptr<SpscRing<LineRecord, kRingSize>> m_lines;
+    std::unique_ptr<SpscRing<EventRecord, kRingSize>> m_events;
+    std::unique_ptr<SpscRing<OutputItem, kRingSize>> m_output;
+    std::atomic<bool> m_rejected{false};  // set by the parser to stop the reader early
+    std::atomic<Verdict> m_verdict{Verdict::Pending};  // of the validator
+    std::string m_errorLine;              // written by the parser before its Reject
+    std::string m_head;                   // text of the club stage the formatter still views
+    std::string m_tail;
+
+    // Check the whole input ahead of the parser, which the rings keep only a few
+    // thousand lines ahead of the formatter, so the output can go out before the day ends.
+    void validate() {
+        Parser parser(Parser::InMemory{}, m_input);
+        ClubConfig config;
+        std::string errorLine;
+        EventView event;
+        bool accepted = parser.ReadConfig(config, errorLine);
+        while (accepted && !m_rejected.load(std::memory_order_relaxed) && parser.NextEvent(event, errorLine)) {}
+        accepted = accepted && !parser.Failed() && !m_rejected.load(std::memory_order_relaxed);
+        m_verdict.store(accepted ? Verdict::Accepted : Verdict::Rejected, std::memory_order_release);
+    }
+
+    void read() {
+        std::string_view data = m_input;
+        while (!data.empty() && !m_rejected.load(std::memory_order_relaxed)) {
+            size_t end = data.find('\n');
+            std::string_view line = data.substr(0, end);
+            data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+            m_lines->push({line, false});
+        }
+        m_lines->push({{}, true});
+    }
+
+    void parse() {
+        LineParser state;
+        EventData unused;
+        bool accepted = true;
+        LineRecord line;
+        while (!(line = m_lines->pop()).end) {
+            while (!line.text.empty() && line.text.back() == '\r')
+                line.text.remove_suffix(1);
+            if (!state.configured()) {
+                LineParser::Result result = state.feed(line.text, unused, m_errorLine);
+                if (result == LineParser::Result::Config)
+                    m_events->push({EventRecord::Config, {}, state.config()});
+                accepted = result != LineParser::Result::Error;
+            } else if (!line.text.empty()) {
+                EventRecord record{EventRecord::Event, {}, {}};
+                accepted = parseEvent(line.text, record.event, state.config());
+                if (accepted)
+                    m_events->push(record);
+                else
+                    m_errorLine = line.text;
+            }
+            if (!accepted)
+                break;
+        }
+        if (accepted && !state.finish(m_errorLine))
+            accepted = false;
+        if (accepted) {
+            m_events->push({EventRecord::End, {}, {}});
+            return;
+        }
+        m_events->push({EventRecord::Reject, {}, {}});
+        // The reader stops soon; take what it has queued so it is not left blocked.
+        m_rejected.store(true, std::memory_order_relaxed);
+        while (!line.end)
+            line = m_lines->pop();
+    }
+
+    void apply() {
+        EventRecord record = m_events->pop();
+        if (record.kind == EventRecord::Reject) {
+            m_output->push({OutputItem::Reject, {}, m_errorLine});
+            return;
+        }
+        const ClubConfig config = record.config;
+        ClientNames names;
+        std::vector<std::string_view> nameText;  // client names as they are in the input
+        Club club(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &names);
+        club.setOutputMode(m_mode);
+        if (m_mode == OutputMode::Full) {
+            m_head = club.getOpenTimeStr() + "\n";
+            m_output->push({OutputItem::Text, {}, m_head});
+        }
+        while ((record = m_events->pop()).kind == EventRecord::Event) {
+            ClientId client = names.intern(record.event.clientName);
+            if (client == static_cast<ClientId>(nameText.size()))
+                nameText.push_back(record.event.clientName);
+            club.processEvent(record.event, client);
+            forward(club, record.event.line, nameText);
+        }
+        if (record.kind == EventRecord::Reject) {
+            m_output->push({OutputItem::Reject, {}, m_errorLine});
+            return;
+        }
+        club.endOfDay();
+        forward(club, {}, nameText);
+        MemorySink tail;
+        if (m_mode == OutputMode::Full)
+            tail.line(club.getCloseTimeStr());
+        if (m_mode == OutputMode::Full || m_mode == OutputMode::ReportOnly)
+            club.writeReport(tail);
+        else if (m_mode == OutputMode::Summary)
+            club.writeSummary(tail);
+        m_tail = tail.data();
+        m_output->push({OutputItem::Text, {}, m_tail});
+        m_output->push({OutputItem::End, {}, {}});
+    }
+
+    // Hand the records of the last event over to the formatter with views into the
+    // input instead of the club's names, so the club can go on meanwhile.
+    void forward(Club &club, std::string_view line, const std::vector<std::string_view> &nameText) {
+        for (const auto &record : club.getRecords()) {
+            if (record.eventId == OutputRecord::kRawLine)
+                m_output->push({OutputItem::Line, {}, line});  // only the echo of the event itself
+            else if (record.eventId == 13)
+                m_output->push({OutputItem::Record, record, errorName(static_cast<ClubError>(record.value))});
+            else
+                m_output->push({OutputItem::Record, record, nameText[record.client]});
+        }
+        club.discardOutput();
+    }
+
+    // The output is held only until the validator accepts the input, then written
+    // whenever a piece of it is formatted.
+    bool format(OutputSink &out) {
+        MemorySink text;
+        while (true) {
+            OutputItem item = m_output->pop();
+            switch (item.kind) {
+            case OutputItem::Record:
+                writeRecord(item.record, item.text, text);
+                break;
+            case OutputItem::Line:
+                text.line(item.text);
+                break;
+            case OutputItem::Text:
+                text.append(item.text);
+                break;
+            case OutputItem::Reject:
+                out.line(item.text);
+                return false;
+            case OutputItem::End:
+                write(text, out);
+                return true;
+            }
+            if (text.data().size() >= kWritePiece && m_verdict.load(std::memory_order_acquire) == Verdict::Accepted)
+                write(text, out);
+        }
+    }
+
+    // In pieces, so a file sink does not hold a second copy of the output.
+    static void write(MemorySink &text, OutputSink &out) {
+        for (std::string_view rest = text.data(); !rest.empty(); rest.remove_prefix(std::min(rest.size(), kWritePiece))) {
+            out.append(rest.substr(0, kWritePiece));
+            out.flush();
+        }
+        text.clear();
+    }
+};
+
+}
+
+bool runPipelined(const std::string &filename, OutputSink &out, OutputMode mode) {
+    // A file that cannot be opened reads as empty and is reported as missing config lines.
+    MappedFile file;
+    file.open(filename);
+    Pipeline pipeline(file.data(), mode);
+    return pipeline.run(out);
+}
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "OutputSink.hpp"
+#include "Club.hpp"
+#include <string>
+
+namespace Yadro {
+
+// Same output as runClubFile, with the day split into four stages on threads of
+// their own: finding the lines of the mapped file, parsing them, applying them to
+// the club and formatting the output. Fixed-size records flow between the stages
+// through bounded SPSC rings, so the stages overlap and the slowest one sets the
+// pace. As in the file mode a rejected input writes only its first bad line, so a
+// fifth thread checks the whole input ahead of the stages and the formatter holds
+// its output only until that check accepts it; after that it writes as it goes.
+bool runPipelined(const std::string &filename, OutputSink &out, OutputMode mode = OutputMode::Full);
+
+}
@@ -0,0 +1,407 @@
+#include "Runner.hpp"
+#include "Club.hpp"
+#include "Parser.hpp"
+#include "LineSplitter.hpp"
+#include "ThreadPool.hpp"
+#include "MappedFile.hpp"
+#include "Utilization.hpp"
+#include "Time.hpp"
+#include "Utils.hpp"
+#include <memory>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Yadro {
+
+bool runClubFile(const std::string &filename, OutputSink &out, unsigned jobs, RunStats *stats,
+                 std::pmr::memory_resource *memory, OutputMode mode) {
+    uint64_t readStart = stats != nullptr ? RunStats::now() : 0;
+    Parser parser(filename, memory);
+    if (stats != nullptr)
+        stats->phaseNanos[RunStats::Read] += RunStats::now() - readStart;
+    ClubConfig config;
+    std::string errorLine;
+    bool configured;
+    {
+        PhaseTimer timer(stats, RunStats::Parse);
+        configured = parser.ReadConfig(config, errorLine);
+    }
+    if (!configured) {
+        // Output the first line with the error and terminate the program.
+        out.line(errorLine);
+        return false;
+    }
+
+    Club club(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &parser.names(), memory);
+    club.setStats(stats);
+    club.setOutputMode(mode);
+
+    if (jobs != 1 && parser.RemainingBytes() > Parser::kChunkSize) {
+        // Chunks are parsed on the pool while this thread applies the parsed ones.
+        ThreadPool pool(jobs);
+        uint64_t start = stats != nullptr ? RunStats::now() : 0;
+        uint64_t processing = 0;
+        parser.ParseChunks(pool, [&club, stats, &processing](const std::vector<EventView> &events) {
+            if (stats == nullptr) {
+                for (const auto &event : events)
+                    club.processEvent(event);
+                return;
+            }
+            for (const auto &event : events) {
+                uint64_t before = RunStats::now();
+                club.processEvent(event);
+                uint64_t latency = RunStats::now() - before;
+                stats->addLatency(latency);
+                processing += latency;
+            }
+        }, errorLine);
+        if (stats != nullptr) {
+            // Parsing runs on the pool: count the time the club waited for it.
+            stats->phaseNanos[RunStats::Process] += processing;
+            stats->phaseNanos[RunStats::Parse] += RunStats::now() - start - processing;
+        }
+    } else if (stats == nullptr) {
+        // Each event is applied as soon as it is parsed, so the input is never held in memory.
+        EventView event;
+        while (parser.NextEvent(event, errorLine)) {
+            club.processEvent(event);
+        }
+    } else {
+        // The same loop, timing the parser and the club separately.
+        EventView event;
+        uint64_t start = RunStats::now();
+        while (parser.NextEvent(event, errorLine)) {
+            uint64_t parsed = RunStats::now();
+            club.processEvent(event);
+            uint64_t processed = RunStats::now();
+            stats->phaseNanos[RunStats::Parse] += parsed - start;
+            stats->phaseNanos[RunStats::Process] += processed - parsed;
+            stats->addLatency(processed - parsed);
+            start = processed;
+        }
+        stats->phaseNanos[RunStats::Parse] += RunStats::now() - start;
+    }
+    if (parser.Failed()) {
+        // Output the first line with the error and terminate the program.
+        out.line(errorLine);
+        return false;
+    }
+
+    finishClubDay(club, out, stats);
+    return true;
+}
+
+namespace {
+
+// Make a rename into the directory of path survive a crash.
+bool syncDirectoryOf(const std::string &path) {
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+// Read fd to its end and call onLine for each line, the last one even without its
+// newline. out is flushed after every read, so the output of the lines goes out as
+// they come in. Stops reading once onLine returns false.
+template <typename OnLine>
+void readLines(int fd, OutputSink &out, OnLine onLine) {
+    LineSplitter lines;
+    char chunk[65536];
+    while (true) {
+        ssize_t count = ::read(fd, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            break;
+        bool more = lines.feed(std::string_view(chunk, count), onLine);
+        out.flush();
+        if (!more)
+            return;
+    }
+    lines.finish(onLine);
+}
+
+// Club day fed one input line at a time, writing the output of each line at once.
+class OnlineDay {
+public:
+    OnlineDay(OutputSink &out, const OnlineOptions &options, std::vector<std::string> &errors)
+        : m_out(out), m_options(options), m_errors(errors) {
+        m_state.setNames(&m_names);
+    }
+
+    // Start from a checkpoint instead of the config lines.
+    bool resume(const std::string &path) {
+        MappedFile file;
+        ClubConfig config;
+        if (!file.open(path) || !Club::checkpointConfig(file.data(), config)) {
+            m_errors.push_back("Error: Cannot read checkpoint " + path);
+            return false;
+        }
+        m_club = std::make_unique<Club>(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &m_names);
+        if (!m_club->restoreCheckpoint(file.data())) {
+            m_errors.push_back("Error: Cannot read checkpoint " + path);
+            return false;
+        }
+        m_state.configure(config);
+        m_skipConfigLines = 3;
+        m_skipEvents = m_club->eventsProcessed();
+        return true;
+    }
+
+    // False once the day is over or the input was rejected.
+    bool feed(std::string_view line) {
+        while (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (m_skipConfigLines > 0) {
+            m_skipConfigLines--;
+            return true;
+        }
+        if (m_skipEvents > 0) {
+            if (!line.empty())
+                m_skipEvents--;
+            return true;
+        }
+        EventData event;
+        std::string errorLine;
+        LineParser::Result result = m_state.feed(line, event, errorLine);
+        if (result == LineParser::Result::Error)
+            return reject(errorLine);
+        if (result == LineParser::Result::Config) {
+            const ClubConfig &config = m_state.config();
+            m_club = std::make_unique<Club>(config.numTables, config.openTime, config.closeTime, config.hourlyCost, &m_names);
+            m_out.line(m_club->getOpenTimeStr());
+        } else if (result == LineParser::Result::Event) {
+            if (event.time > m_state.config().closeTime) {
+                finish();
+                return false;
+            }
+            m_club->processEvent(event);
+            m_club->writeOutput(m_out, m_written);
+            m_written = m_club->getRecords().size();
+            if (!m_options.checkpointPath.empty() && m_options.checkpointEvery > 0
+                && m_club->eventsProcessed() % m_options.checkpointEvery == 0)
+                checkpoint();
+        }
+        return true;
+    }
+
+    // End of input: close the day if it is still open.
+    bool finish() {
+        if (m_done)
+            return !m_rejected;
+        std::string errorLine;
+        if (!m_state.finish(errorLine))
+            return reject(errorLine);
+        m_done = true;
+        m_club->endOfDay();
+        m_club->writeOutput(m_out, m_written);
+        m_out.line(m_club->getCloseTimeStr());
+        m_club->writeReport(m_out);
+        return true;
+    }
+
+    bool rejected() const { return m_rejected; }
+private:
+    OutputSink &m_out;
+    const OnlineOptions &m_options;
+    std::vector<std::string> &m_errors;
+    ClientNames m_names;
+    LineParser m_state;
+    std::unique_ptr<Club> m_club;
+    size_t m_written = 0;
+    size_t m_skipConfigLines = 0;
+    size_t m_skipEvents = 0;
+    std::string m_checkpoint;
+    bool m_checkpointFailed = false;
+    bool m_done = false;
+    bool m_rejected = false;
+
+    void checkpoint() {
+        if (m_checkpointFailed)
+            return;
+        // The output of the events in the checkpoint must not be lost after a restart.
+        m_out.flush();
+        m_checkpoint.clear();
+        m_club->saveCheckpoint(m_checkpoint);
+        std::string temporary = m_options.checkpointPath + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool written = fd >= 0;
+        if (written) {
+            FdSink file(fd);
+            file.append(m_checkpoint);
+            file.flush();
+            // On disk before the rename, so a crash cannot leave an empty checkpoint.
+            written = file.good() && ::fsync(fd) == 0;
+        }
+        if (fd >= 0 && ::close(fd) != 0)
+            written = false;
+        if (!written || std::rename(temporary.c_str(), m_options.checkpointPath.c_str()) != 0
+            || !syncDirectoryOf(m_options.checkpointPath)) {
+            m_errors.push_back("Error: Cannot write checkpoint " + m_options.checkpointPath);
+            m_checkpointFailed = true;
+        }
+    }
+
+    bool reject(const std::string &errorLine) {
+        m_out.line(errorLine);
+        m_done = true;
+        m_rejected = true;
+        return false;
+    }
+};
+
+}
+
+bool runOnline(int fd, OutputSink &out) {
+    std::vector<std::string> errors;
+    return runOnline(fd, out, OnlineOptions(), errors);
+}
+
+bool runOnline(int fd, OutputSink &out, const OnlineOptions &options, std::vector<std::string> &errors) {
+    OnlineDay day(out, options, errors);
+    if (!options.resumePath.empty() && !day.resume(options.resumePath))
+        return false;
+    readLines(fd, out, [&day](std::string_view line) { return day.feed(line); });
+    day.finish();
+    out.flush();
+    return !day.rejected();
+}
+
+namespace {
+
+bool answerQuery(const Club &club, std::string_view query, OutputSink &out) {
+    Util::Tokens tokens = Util::splitString(query);
+    if (tokens.size() == 0)
+        return false;
+    const SessionIndex &sessions = club.sessions();
+    if (tokens[0] == "busy" && tokens.size() == 2) {
+        auto time = Time::FromString(tokens[1]);
+        if (!time.has_value())
+            return false;
+        out.line(std::to_string(sessions.busyTablesAt(time.value())));
+        return true;
+    }
+    if (tokens[0] == "table" && tokens.size() == 3) {
+        auto table = Util::FromString(tokens[1]);
+        auto time = Time::FromString(tokens[2]);
+        if (!table.has_value() || !time.has_value() || table.value() < 1
+            || table.value() > static_cast<int>(club.getTables().size()))
+            return false;
+        ClientId client = sessions.clientAt(table.value(), time.value());
+        out.line(client == kNoClient ? std::string_view("free") : std::string_view(club.clientName(client)));
+        return true;
+    }
+    if (tokens[0] == "overlap" && tokens.size() == 3) {
+        auto from = Time::FromString(tokens[1]);
+        auto to = Time::FromString(tokens[2]);
+        if (!from.has_value() || !to.has_value() || from.value() > to.value())
+            return false;
+        std::vector<Session> found = sessions.overlapping(from.value(), to.value());
+        out.line(std::to_string(found.size()));
+        for (const auto &session : found) {
+            out.appendInt(session.table).appendChar(' ').append(club.clientName(session.client)).appendChar(' ')
+                .appendTime(session.start).appendChar(' ');
+            // Only a day that is still going has open sessions.
+            if (session.end == SessionIndex::kOpen)
+                out.appendChar('-');
+            else
+                out.appendTime(session.end);
+            out.endLine();
+        }
+        return true;
+    }
+    return false;
+}
+
+// Run the whole day of the parser's file with the sessions recorded. On a bad
+// line it is written to out and nullptr is returned.
+std::unique_ptr<Club> runRecordedDay(Parser &parser, ClubConfig &config, OutputSink &out) {
+    std::string errorLine;
+    if (!parser.ReadConfig(config, errorLine)) {
+        out.line(errorLine);
+        return nullptr;
+    }
+    auto club = std::make_unique<Club>(config.numTables, config.openTime, config.closeTime, config.hourlyCost,
+                                       &parser.names());
+    club->recordSessions();
+    EventData event;
+    while (parser.NextEvent(event, errorLine))
+        club->processEvent(event);
+    if (parser.Failed()) {
+        out.line(errorLine);
+        return nullptr;
+    }
+    club->endOfDay();
+    return club;
+}
+
+}
+
+bool runSessionQueries(const std::string &filename, int queryFd, OutputSink &out) {
+    Parser parser(filename);
+    ClubConfig config;
+    std::unique_ptr<Club> day = runRecordedDay(parser, config, out);
+    if (day == nullptr)
+        return false;
+    const Club &club = *day;
+
+    readLines(queryFd, out, [&club, &out](std::string_view query) {
+        while (!query.empty() && query.back() == '\r')
+            query.remove_suffix(1);
+        if (!query.empty() && !answerQuery(club, query, out)) {
+            out.append("error ");
+            out.line(query);
+        }
+        return true;
+    });
+    out.flush();
+    return true;
+}
+
+bool runUtilization(const std::string &filename, int bucketMinutes, OutputSink &out) {
+    Parser parser(filename);
+    ClubConfig config;
+    std::unique_ptr<Club> club = runRecordedDay(parser, config, out);
+    if (club == nullptr)
+        return false;
+    writeUtilization(club->recordedSessions(), config, bucketMinutes, out);
+    return true;
+}
+
+void finishClubDay(Club &club, OutputSink &out, RunStats *stats) {
+    {
+        PhaseTimer timer(stats, RunStats::EndOfDay);
+        club.endOfDay();
+    }
+    PhaseTimer timer(stats, RunStats::Report);
+    switch (club.outputMode()) {
+    case OutputMode::Full:
+        break;
+    case OutputMode::ReportOnly:
+        club.writeReport(out);
+        return;
+    case OutputMode::ErrorsOnly:
+        // Only the events 13 were kept.
+        club.writeOutput(out);
+        return;
+    case OutputMode::Summary:
+        club.writeSummary(out);
+        return;
+    }
+    // Now we have all the events processed and the output is ready.
+    out.line(club.getOpenTimeStr());
+    club.writeOutput(out);
+    out.line(club.getCloseTimeStr());
+
+    // Making the final report about the revenue.
+    club.writeReport(out);
+}
+
+}
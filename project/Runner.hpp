@@ -0,0 +1,62 @@
+#pragma once
+
+#include "OutputSink.hpp"
+#include "Stats.hpp"
+#include "Club.hpp"
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace Yadro {
+
+// Run one club day from an input file and write the whole output into out:
+// the open time, all events, the close time and the report, or only the first
+// bad line. Returns false if the input was rejected.
+// With jobs != 1 a file larger than a parser chunk is parsed on jobs threads
+// (0 means one per core) while the club applies the events in order.
+// With stats the run is counted and timed into it. The parser and club state of the
+// day is allocated from memory, which can be released as a whole after the call.
+// mode selects what is written for an accepted day; a bad line is always written.
+bool runClubFile(const std::string &filename, OutputSink &out, unsigned jobs = 1, RunStats *stats = nullptr,
+                 std::pmr::memory_resource *memory = std::pmr::get_default_resource(),
+                 OutputMode mode = OutputMode::Full);
+
+// Online mode: read the input from fd as it arrives and write the output of every
+// event to out as soon as the event is applied; out is flushed after each read.
+// The day ends at the first event later than the close time (that event and the
+// rest of the input are not applied) or at the end of input. A bad line is printed
+// and stops the run, but the output written before it stays. Returns false if the
+// input was rejected.
+bool runOnline(int fd, OutputSink &out);
+
+struct OnlineOptions {
+    std::string checkpointPath;     // checkpoint file to keep up to date, none if empty
+    size_t checkpointEvery = 4096;  // events between two checkpoints
+    std::string resumePath;         // checkpoint to start from, none if empty
+};
+
+// Same with checkpoints. A checkpoint is written (atomically, by rename) every
+// checkpointEvery events. When resuming, the input is the same log from its start:
+// the config lines and the events already in the checkpoint are skipped unparsed.
+// Problems with the checkpoint files are reported in errors.
+bool runOnline(int fd, OutputSink &out, const OnlineOptions &options, std::vector<std::string> &errors);
+
+// Run the day of an input file with its sessions recorded, then answer the queries
+// read from queryFd, one per line, with one answer each:
+//   busy HH:MM               number of tables taken at that minute
+//   table <n> HH:MM          client at table n at that minute, or "free"
+//   overlap HH:MM HH:MM      number of sessions sharing a minute with the range,
+//                            then "<table> <client> <start> <end>" for each of them
+// A query that cannot be read is answered with "error <query>". If the input file
+// is rejected, only its first bad line is written and false is returned.
+bool runSessionQueries(const std::string &filename, int queryFd, OutputSink &out);
+
+// Run the day of an input file and write its bucketed utilization report (see
+// writeUtilization) with buckets of bucketMinutes, or only the first bad line.
+bool runUtilization(const std::string &filename, int bucketMinutes, OutputSink &out);
+
+// Run endOfDay and write the output of an accepted club day into out, as much
+// of it as the output mode of the club asks for.
+void finishClubDay(Club &club, OutputSink &out, RunStats *stats = nullptr);
+
+}
@@ -0,0 +1,327 @@
+#include "Server.hpp"
+#include "ParserHelpers.hpp"
+#include "Utils.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Yadro {
+
+namespace {
+
+// Cut the first word and the spaces after it off text.
+std::string_view takeWord(std::string_view &text) {
+    size_t start = 0;
+    while (start < text.size() && Util::isSpace(text[start]))
+        start++;
+    size_t end = start;
+    while (end < text.size() && !Util::isSpace(text[end]))
+        end++;
+    std::string_view word = text.substr(start, end - start);
+    text.remove_prefix(end);
+    while (!text.empty() && Util::isSpace(text.front()))
+        text.remove_prefix(1);
+    return word;
+}
+
+void answerError(OutputSink &out, std::string_view reason) {
+    out.append("error ").line(reason);
+}
+
+void answerValue(OutputSink &out, long long value) {
+    out.append("ok 1\n").appendInt(value).endLine();
+}
+
+// Send as much of the connection's output as the socket takes now. False on an error.
+bool sendOutput(int fd, std::string &output, size_t &sent) {
+    while (sent < output.size()) {
+        ssize_t count = ::send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+        if (count >= 0) {
+            sent += count;
+            continue;
+        }
+        if (errno == EINTR)
+            continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    output.clear();
+    sent = 0;
+    return true;
+}
+
+}
+
+ClubServer::ClubServer(unsigned jobs) : m_pool(jobs) {
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = &m_stopFd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_stopFd, &event);
+}
+
+ClubServer::~ClubServer() {
+    m_pool.wait();
+    for (auto &[fd, connection] : m_connections)
+        ::close(fd);
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        ::unlink(m_path.c_str());
+    }
+    ::close(m_stopFd);
+    ::close(m_epollFd);
+}
+
+bool ClubServer::listen(const std::string &path, std::string &errorLine) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        errorLine = "Error: Bad socket path " + path;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    // A socket file left behind by a server that is gone would make bind fail;
+    // anything else at path is kept.
+    struct stat existing;
+    if (::stat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode))
+        ::unlink(path.c_str());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || ::listen(fd, SOMAXCONN) != 0) {
+        errorLine = "Error: Cannot listen on " + path + ": " + std::strerror(errno);
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = &m_listenFd;
+    if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        errorLine = "Error: Cannot listen on " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        ::unlink(path.c_str());
+        return false;
+    }
+    m_listenFd = fd;
+    m_path = path;
+    return true;
+}
+
+void ClubServer::run() {
+    epoll_event events[64];
+    bool running = true;
+    while (running) {
+        int count = ::epoll_wait(m_epollFd, events, 64, -1);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0)
+            break;
+        for (int i = 0; i < count; i++) {
+            void *source = events[i].data.ptr;
+            if (source == &m_stopFd) {
+                running = false;
+            } else if (source == &m_listenFd) {
+                accept();
+            } else {
+                // The connection stays disarmed until serve() is done with it.
+                auto *connection = static_cast<Connection *>(source);
+                m_pool.submit([this, connection] { serve(connection); });
+            }
+        }
+    }
+    uint64_t stops;
+    if (::read(m_stopFd, &stops, sizeof(stops)) < 0) {}
+    m_pool.wait();
+}
+
+void ClubServer::stop() {
+    uint64_t one = 1;
+    if (::write(m_stopFd, &one, sizeof(one)) < 0) {}
+}
+
+void ClubServer::accept() {
+    while (true) {
+        int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0 && errno == EINTR)
+            continue;
+        if (fd < 0)
+            return;
+        Connection *connection;
+        {
+            std::lock_guard<std::mutex> lock(m_connectionsMutex);
+            connection = m_connections.emplace(fd, std::make_unique<Connection>(fd)).first->second.get();
+        }
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.ptr = connection;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+            closeConnection(connection);
+    }
+}
+
+void ClubServer::serve(Connection *connection) {
+    if (connection->output.empty() && !connection->closing)
+        readRequests(*connection);
+    if (!sendOutput(connection->fd, connection->output, connection->sent)
+        || (connection->closing && connection->output.empty())) {
+        closeConnection(connection);
+        return;
+    }
+    // A client that does not read its answers only stalls itself.
+    epoll_event event{};
+    event.events = (connection->output.empty() ? EPOLLIN | EPOLLRDHUP : EPOLLOUT) | EPOLLONESHOT;
+    event.data.ptr = connection;
+    if (::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, connection->fd, &event) != 0)
+        closeConnection(connection);
+}
+
+void ClubServer::readRequests(Connection &connection) {
+    char chunk[65536];
+    ssize_t count;
+    do {
+        count = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+    } while (count < 0 && errno == EINTR);
+    connection.closing = count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+
+    MemorySink answers;
+    auto answer = [this, &answers](std::string_view request) {
+        handle(request, answers);
+        return true;
+    };
+    connection.requests.feed(std::string_view(chunk, count > 0 ? count : 0), answer);
+    if (connection.closing)
+        connection.requests.finish(answer);
+    if (connection.requests.pendingSize() > kMaxRequest) {
+        answerError(answers, "request too long");
+        connection.closing = true;
+    }
+    connection.output.append(answers.data());
+}
+
+void ClubServer::closeConnection(Connection *connection) {
+    // Closed under the lock, so accept() cannot get the same fd before it is erased.
+    std::lock_guard<std::mutex> lock(m_connectionsMutex);
+    int fd = connection->fd;
+    m_connections.erase(fd);
+    ::close(fd);
+}
+
+void ClubServer::handle(std::string_view request, OutputSink &out) {
+    while (!request.empty() && request.back() == '\r')
+        request.remove_suffix(1);
+    std::string_view rest = request;
+    std::string_view command = takeWord(rest);
+    if (command.empty())
+        return;
+    if (command == "clubs" && rest.empty()) {
+        std::shared_lock<std::shared_mutex> lock(m_clubsMutex);
+        out.append("ok ").appendInt(static_cast<long long>(m_clubs.size())).endLine();
+        for (const auto &[name, resident] : m_clubs)
+            out.line(name);
+        return;
+    }
+    std::string_view name = takeWord(rest);
+    if (name.empty()) {
+        answerError(out, "bad request");
+        return;
+    }
+    if (command == "open") {
+        openClub(name, rest, out);
+        return;
+    }
+    bool query = command == "occupancy" || command == "revenue" || command == "queue";
+    if ((command == "close" || query) && !rest.empty()) {
+        answerError(out, "bad request");
+        return;
+    }
+    if (command == "close") {
+        closeClub(name, out);
+        return;
+    }
+    if (command != "event" && !query) {
+        answerError(out, "bad request");
+        return;
+    }
+
+    std::shared_lock<std::shared_mutex> clubsLock(m_clubsMutex);
+    auto it = m_clubs.find(name);
+    if (it == m_clubs.end()) {
+        answerError(out, "unknown club");
+        return;
+    }
+    Resident &resident = *it->second;
+    std::lock_guard<std::mutex> lock(resident.mutex);
+    Club &club = *resident.club;
+    if (command == "occupancy") {
+        out.append("ok 1\n").appendInt(club.busyTables()).appendChar(' ').appendInt(resident.config.numTables).endLine();
+    } else if (command == "revenue") {
+        answerValue(out, club.revenue());
+    } else if (command == "queue") {
+        answerValue(out, static_cast<long long>(club.waitingClients()));
+    } else {
+        EventView event;
+        if (!parseEvent(rest, event, resident.config)) {
+            answerError(out, "bad event");
+            return;
+        }
+        club.processEvent(event);
+        out.append("ok ").appendInt(static_cast<long long>(club.getRecords().size())).endLine();
+        club.writeOutput(out);
+        club.discardOutput();
+    }
+}
+
+void ClubServer::openClub(std::string_view name, std::string_view configText, OutputSink &out) {
+    Util::Tokens tokens = Util::splitString(configText);
+    ClubConfig config;
+    std::string errorLine;
+    if (tokens.size() != 4 || !parseTableCount(tokens[0], config, errorLine)
+        || !parseOperatingHours(std::string_view(tokens[1].data(), tokens[2].data() + tokens[2].size() - tokens[1].data()),
+                                config, errorLine)
+        || !parseHourlyCost(tokens[3], config, errorLine)) {
+        answerError(out, "bad config");
+        return;
+    }
+    auto resident = std::make_unique<Resident>();
+    resident->config = config;
+    resident->club = std::make_unique<Club>(config.numTables, config.openTime, config.closeTime, config.hourlyCost);
+    {
+        std::unique_lock<std::shared_mutex> lock(m_clubsMutex);
+        if (m_clubs.find(name) != m_clubs.end()) {
+            answerError(out, "club exists");
+            return;
+        }
+        m_clubs.emplace(std::string(name), std::move(resident));
+    }
+    out.append("ok 1\n").appendTime(config.openTime).endLine();
+}
+
+void ClubServer::closeClub(std::string_view name, OutputSink &out) {
+    std::unique_ptr<Resident> resident;
+    {
+        // Waits for the requests still using the club.
+        std::unique_lock<std::shared_mutex> lock(m_clubsMutex);
+        auto it = m_clubs.find(name);
+        if (it == m_clubs.end()) {
+            answerError(out, "unknown club");
+            return;
+        }
+        resident = std::move(it->second);
+        m_clubs.erase(it);
+    }
+    Club &club = *resident->club;
+    club.endOfDay();
+    size_t lines = club.getRecords().size() + 1 + club.getTables().size();
+    out.append("ok ").appendInt(static_cast<long long>(lines)).endLine();
+    club.writeOutput(out);
+    out.line(club.getCloseTimeStr());
+    club.writeReport(out);
+}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Club.hpp"
+#include "LineSplitter.hpp"
+#include "OutputSink.hpp"
+#include "ThreadPool.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Yadro {
+
+// Resident clubs served over a Unix domain stream socket. Each request is one line
+// and gets one answer: "ok <n>" followed by n lines, or "error <reason>".
+//   open <club> <tables> <open> <close> <cost>  start the day of a new club: its open time
+//   event <club> <event line>                   apply an event: the output lines it caused
+//   occupancy <club>                            "<busy tables> <tables>"
+//   revenue <club>                              revenue of the sessions that ended so far
+//   queue <club>                                number of waiting clients
+//   close <club>                                endOfDay: the rest of the output, the close
+//                                               time and the report; the club is removed
+//   clubs                                       names of the clubs, one per line
+// The answers for one club put together are the output main gives for its input file.
+class ClubServer {
+public:
+    // Longest request line; a connection sending a longer one is closed
+    static constexpr size_t kMaxRequest = 1 << 16;
+
+    // jobs: worker threads serving the connections, 0 means one per core
+    explicit ClubServer(unsigned jobs = 0);
+    ~ClubServer();
+    ClubServer(const ClubServer &) = delete;
+    ClubServer &operator=(const ClubServer &) = delete;
+
+    // Create the socket at path, replacing a stale socket file. False with the reason
+    // in errorLine if it cannot be done.
+    bool listen(const std::string &path, std::string &errorLine);
+    // Accept connections and answer their requests until stop(). Requests of one
+    // connection are answered in order; those of different connections run in parallel.
+    void run();
+    // Make run() return once the requests being handled are answered.
+    // Safe to call from another thread or a signal handler.
+    void stop();
+    // Answer one request line, the same as over the socket.
+    void handle(std::string_view request, OutputSink &out);
+private:
+    // A club with the lock for its events; the map lock only guards opening and closing.
+    struct Resident {
+        std::mutex mutex;
+        ClubConfig config;
+        std::unique_ptr<Club> club;
+    };
+    struct Connection {
+        explicit Connection(int socket) : fd(socket) {}
+        int fd;
+        LineSplitter requests;
+        std::string output;    // answers not sent yet; no request is read until they are
+        size_t sent = 0;       // bytes of output already sent
+        bool closing = false;  // the peer is gone or broke the protocol: close once sent
+    };
+
+    ThreadPool m_pool;
+    std::shared_mutex m_clubsMutex;
+    std::map<std::string, std::unique_ptr<Resident>, std::less<>> m_clubs;
+    std::mutex m_connectionsMutex;
+    std::unordered_map<int, std::unique_ptr<Connection>> m_connections;  // by socket fd
+    std::string m_path;
+    int m_listenFd = -1;
+    int m_epollFd = -1;
+    int m_stopFd = -1;
+
+    void accept();
+    // Send what is left of the connection's answers, or else read what it has and answer
+    // its complete requests, then wait for the socket without blocking a worker: for
+    // writing while answers are left, for reading otherwise. Closes the connection at
+    // its end or on an error.
+    void serve(Connection *connection);
+    void readRequests(Connection &connection);
+    void closeConnection(Connection *connection);
+    void openClub(std::string_view name, std::string_view config, OutputSink &out);
+    void closeClub(std::string_view name, OutputSink &out);
+};
+
+}
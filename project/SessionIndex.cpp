@@ -0,0 +1,85 @@
+#include "SessionIndex.hpp"
+#include <algorithm>
+
+namespace Yadro {
+
+void SessionIndex::build(std::vector<Session> sessions, int tablesCount) {
+    auto byStart = [](const Session &a, const Session &b) { return a.start < b.start; };
+    std::stable_sort(sessions.begin(), sessions.end(), byStart);
+
+    m_starts.clear();
+    m_ends.clear();
+    for (const auto &session : sessions) {
+        m_starts.push_back(session.start);
+        m_ends.push_back(session.end);
+    }
+    std::sort(m_ends.begin(), m_ends.end());
+
+    // Counting sort by table keeps the start order inside each table.
+    m_tableBegin.assign(tablesCount + 1, 0);
+    for (const auto &session : sessions)
+        m_tableBegin[session.table]++;
+    for (int table = 1; table <= tablesCount; table++)
+        m_tableBegin[table] += m_tableBegin[table - 1];
+    std::vector<size_t> next(m_tableBegin.begin(), m_tableBegin.end() - 1);
+    m_byTable.resize(sessions.size());
+    for (const auto &session : sessions)
+        m_byTable[next[session.table - 1]++] = session;
+
+    m_byStart = std::move(sessions);
+    m_maxEnd.assign(4 * std::max<size_t>(m_byStart.size(), 1), 0);
+    if (!m_byStart.empty())
+        buildTree(1, 0, m_byStart.size());
+}
+
+int32_t SessionIndex::buildTree(size_t node, size_t begin, size_t end) {
+    if (end - begin == 1)
+        return m_maxEnd[node] = m_byStart[begin].end;
+    size_t middle = (begin + end) / 2;
+    return m_maxEnd[node] = std::max(buildTree(2 * node, begin, middle), buildTree(2 * node + 1, middle, end));
+}
+
+void SessionIndex::collect(size_t node, size_t begin, size_t end, size_t limit, int from,
+                           std::vector<Session> &result) const {
+    // Skip subtrees past the start limit or with every session over before from.
+    if (begin >= limit || m_maxEnd[node] <= from)
+        return;
+    if (end - begin == 1) {
+        // A session that took no time shares no minute with anything.
+        if (m_byStart[begin].start < m_byStart[begin].end)
+            result.push_back(m_byStart[begin]);
+        return;
+    }
+    size_t middle = (begin + end) / 2;
+    collect(2 * node, begin, middle, limit, from, result);
+    collect(2 * node + 1, middle, end, limit, from, result);
+}
+
+ClientId SessionIndex::clientAt(int table, int time) const {
+    if (table < 1 || table >= static_cast<int>(m_tableBegin.size()))
+        return kNoClient;
+    auto first = m_byTable.begin() + m_tableBegin[table - 1];
+    auto last = m_byTable.begin() + m_tableBegin[table];
+    // The last session of the table that started at or before time
+    auto it = std::upper_bound(first, last, time, [](int value, const Session &session) { return value < session.start; });
+    if (it == first || std::prev(it)->end <= time)
+        return kNoClient;
+    return std::prev(it)->client;
+}
+
+int SessionIndex::busyTablesAt(int time) const {
+    // Every session that ended by time has also started by then.
+    auto started = std::upper_bound(m_starts.begin(), m_starts.end(), time) - m_starts.begin();
+    auto ended = std::upper_bound(m_ends.begin(), m_ends.end(), time) - m_ends.begin();
+    return static_cast<int>(started - ended);
+}
+
+std::vector<Session> SessionIndex::overlapping(int from, int to) const {
+    std::vector<Session> result;
+    size_t limit = std::upper_bound(m_starts.begin(), m_starts.end(), to) - m_starts.begin();
+    if (limit > 0)
+        collect(1, 0, m_byStart.size(), limit, from, result);
+    return result;
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ClientNames.hpp"
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+namespace Yadro {
+
+// One seating of a client at a table, covering the minutes [start, end).
+struct Session {
+    int32_t start;
+    int32_t end;     // SessionIndex::kOpen while the client is still at the table
+    ClientId client;
+    int32_t table;   // table number, 1-based
+};
+
+// Read-only index of sessions for point-in-time occupancy queries:
+// each query is O(log n), plus O(log n) per session returned by overlapping().
+class SessionIndex {
+public:
+    static constexpr int32_t kOpen = INT32_MAX;
+
+    void build(std::vector<Session> sessions, int tablesCount);
+    size_t size() const { return m_byStart.size(); }
+
+    // Client at the table at minute time, kNoClient if the table was free
+    ClientId clientAt(int table, int time) const;
+    // Number of tables taken at minute time
+    int busyTablesAt(int time) const;
+    // Sessions sharing at least one minute with [from, to], in order of their start
+    std::vector<Session> overlapping(int from, int to) const;
+private:
+    std::vector<Session> m_byStart;    // all sessions sorted by start
+    std::vector<int32_t> m_maxEnd;     // segment tree: latest end over a range of m_byStart
+    std::vector<int32_t> m_starts;     // sorted starts
+    std::vector<int32_t> m_ends;       // sorted ends
+    std::vector<Session> m_byTable;    // sessions grouped by table, sorted by start in a group
+    std::vector<size_t> m_tableBegin;  // group of table t is [m_tableBegin[t - 1], m_tableBegin[t])
+
+    int32_t buildTree(size_t node, size_t begin, size_t end);
+    void collect(size_t node, size_t begin, size_t end, size_t limit, int from, std::vector<Session> &result) const;
+};
+
+}
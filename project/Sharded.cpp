@@ -0,0 +1,247 @@
+#include "Sharded.hpp"
+#include "Club.hpp"
+#include "ClientNames.hpp"
+#include "Parser.hpp"
+#include "MappedFile.hpp"
+#include "OutputSink.hpp"
+#include "Runner.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Yadro {
+
+namespace {
+
+struct RoutedLine {
+    std::string_view clubId;
+    std::string_view line;
+};
+using Batch = std::vector<RoutedLine>;
+
+constexpr size_t kBatchLines = 1024;
+constexpr size_t kQueuedBatches = 64;
+
+// Bounded FIFO of line batches from the reader to one shard
+class BatchQueue {
+public:
+    void push(Batch batch) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_batches.size() < kQueuedBatches; });
+        m_batches.push_back(std::move(batch));
+        m_notEmpty.notify_one();
+    }
+
+    bool pop(Batch &batch) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_closed || !m_batches.empty(); });
+        if (m_batches.empty())
+            return false;
+        batch = std::move(m_batches.front());
+        m_batches.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notEmpty.notify_all();
+    }
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Batch> m_batches;
+    bool m_closed = false;
+};
+
+// State of one club inside its shard
+struct ClubShard {
+    ClientNames names;
+    LineParser parser;
+    std::unique_ptr<Club> club;
+    bool failed = false;
+    std::string errorLine;
+};
+
+class Shard {
+public:
+    explicit Shard(const std::string &outputDir) : m_outputDir(outputDir) {}
+
+    BatchQueue &queue() { return m_queue; }
+    void start() { m_thread = std::thread(&Shard::run, this); }
+    void join() { m_thread.join(); }
+    std::vector<ClubSummary> &summary() { return m_summary; }
+    std::vector<std::string> &errors() { return m_errors; }
+private:
+    std::string m_outputDir;
+    BatchQueue m_queue;
+    std::thread m_thread;
+    std::unordered_map<std::string, std::unique_ptr<ClubShard>, NameHash, std::equal_to<>> m_clubs;
+    std::vector<ClubSummary> m_summary;
+    std::vector<std::string> m_errors;
+
+    void run() {
+        Batch batch;
+        EventData event;
+        while (m_queue.pop(batch)) {
+            for (const auto &routed : batch)
+                apply(routed, event);
+        }
+        for (auto &[clubId, state] : m_clubs)
+            finish(clubId, *state);
+    }
+
+    void apply(const RoutedLine &routed, EventData &event) {
+        auto it = m_clubs.find(routed.clubId);
+        if (it == m_clubs.end()) {
+            it = m_clubs.emplace(std::string(routed.clubId), std::make_unique<ClubShard>()).first;
+            it->second->parser.setNames(&it->second->names);
+        }
+        ClubShard &state = *it->second;
+        if (state.failed)
+            return;
+        switch (state.parser.feed(routed.line, event, state.errorLine)) {
+        case LineParser::Result::Config: {
+            const ClubConfig &config = state.parser.config();
+            state.club = std::make_unique<Club>(config.numTables, config.openTime, config.closeTime,
+                                                config.hourlyCost, &state.names);
+            break;
+        }
+        case LineParser::Result::Event:
+            state.club->processEvent(event);
+            break;
+        case LineParser::Result::Error:
+            state.failed = true;
+            break;
+        case LineParser::Result::None:
+            break;
+        }
+    }
+
+    void finish(const std::string &clubId, ClubShard &state) {
+        if (!state.failed && !state.parser.finish(state.errorLine))
+            state.failed = true;
+        ClubSummary summary{clubId, !state.failed, 0, 0};
+        std::string path = (std::filesystem::path(m_outputDir) / (clubId + ".out.txt")).string();
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            m_errors.push_back("Error: Cannot create file " + path);
+        } else {
+            bool written;
+            {
+                FdSink out(fd);
+                if (state.failed)
+                    out.line(state.errorLine);
+                else
+                    finishClubDay(*state.club, out);
+                out.flush();
+                written = out.good();
+            }
+            if (::close(fd) != 0 || !written)
+                m_errors.push_back("Error: Cannot write file " + path);
+        }
+        if (!state.failed) {
+            for (const auto &table : state.club->getTables()) {
+                summary.revenue += table.revenue;
+                summary.occupied += table.totalOccupied;
+            }
+        }
+        m_summary.push_back(std::move(summary));
+        // The output is written, the club state is no longer needed.
+        state.club.reset();
+    }
+};
+
+// Club ids become file names, so they must not leave the output directory.
+bool isValidClubId(std::string_view clubId) {
+    return clubId != "." && clubId != ".." && clubId.find('/') == std::string_view::npos;
+}
+
+}
+
+bool runSharded(const ShardedOptions &options, std::vector<ClubSummary> &summary, std::vector<std::string> &errors) {
+    MappedFile input;
+    if (!input.open(options.input)) {
+        errors.push_back("Error: Cannot open file " + options.input);
+        return false;
+    }
+    unsigned shardsCount = options.jobs != 0 ? options.jobs : std::thread::hardware_concurrency();
+    if (shardsCount == 0)
+        shardsCount = 1;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    for (unsigned i = 0; i < shardsCount; i++) {
+        shards.push_back(std::make_unique<Shard>(options.outputDir));
+        shards.back()->start();
+    }
+
+    // The reader splits off the club id and hands views into the mapped file to
+    // the shards; all lines of one club go through the same FIFO queue.
+    std::vector<Batch> pending(shardsCount);
+    std::string_view data = input.data();
+    size_t pos = 0;
+    size_t lineNum = 0;
+    bool ok = true;
+    while (pos < data.size()) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string_view::npos)
+            end = data.size();
+        std::string_view line = data.substr(pos, end - pos);
+        pos = end + 1;
+        lineNum++;
+        while (!line.empty() && (line.back() == '\r'))
+            line.remove_suffix(1);
+
+        size_t idEnd = 0;
+        while (idEnd < line.size() && !Util::isSpace(line[idEnd]))
+            idEnd++;
+        if (idEnd == 0)
+            continue;
+        std::string_view clubId = line.substr(0, idEnd);
+        if (!isValidClubId(clubId)) {
+            errors.push_back("Error: Bad club id in line " + std::to_string(lineNum));
+            ok = false;
+            continue;
+        }
+        // One separator character, the rest is the club's own line as is.
+        std::string_view clubLine = idEnd < line.size() ? line.substr(idEnd + 1) : std::string_view();
+        size_t shardIndex = std::hash<std::string_view>{}(clubId) % shardsCount;
+        pending[shardIndex].push_back({clubId, clubLine});
+        if (pending[shardIndex].size() >= kBatchLines) {
+            shards[shardIndex]->queue().push(std::move(pending[shardIndex]));
+            pending[shardIndex] = Batch();
+            pending[shardIndex].reserve(kBatchLines);
+        }
+    }
+    for (unsigned i = 0; i < shardsCount; i++) {
+        if (!pending[i].empty())
+            shards[i]->queue().push(std::move(pending[i]));
+        shards[i]->queue().close();
+    }
+
+    for (auto &shard : shards) {
+        shard->join();
+        for (auto &clubSummary : shard->summary())
+            summary.push_back(std::move(clubSummary));
+        for (auto &error : shard->errors()) {
+            errors.push_back(std::move(error));
+            ok = false;
+        }
+    }
+    std::sort(summary.begin(), summary.end(), [](const ClubSummary &a, const ClubSummary &b) {
+        return a.clubId < b.clubId;
+    });
+    return ok;
+}
+
+}
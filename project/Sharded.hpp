@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Yadro {
+
+struct ShardedOptions {
+    std::string input;               // combined stream, each line is "<club_id> <line of the club's input>"
+    std::string outputDir = ".";
+    unsigned jobs = 0;               // 0 means one shard per core
+};
+
+struct ClubSummary {
+    std::string clubId;
+    bool accepted;                   // false if the club's input was rejected
+    long long revenue;
+    long long occupied;              // minutes over all tables
+};
+
+// Route each line of the combined stream by club id to the shard thread that owns
+// that club's Club, so the events of one club are applied in stream order. Each
+// club's output goes to "<outputDir>/<club_id>.out.txt"; summary gets one entry
+// per club, sorted by club id. Returns false if some line or file failed.
+bool runSharded(const ShardedOptions &options, std::vector<ClubSummary> &summary, std::vector<std::string> &errors);
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace Yadro {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Each side caches the other side's index, so the shared ones are read only when
+// the ring looks full or empty. T should be small and trivially copyable.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+public:
+    // Producer side
+    bool tryPush(const T &item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity)
+                return false;
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T &item) {
+        for (unsigned tries = 0; !tryPush(item); tries++)
+            backOff(tries);
+    }
+
+    // Consumer side
+    bool tryPop(T &item) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+                return false;
+        }
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    T pop() {
+        T item;
+        for (unsigned tries = 0; !tryPop(item); tries++)
+            backOff(tries);
+        return item;
+    }
+private:
+    static constexpr size_t kLine = 64;
+
+    // Spin briefly for a stage on another core, then give the core away.
+    static void backOff(unsigned tries) {
+        if (tries >= 64)
+            std::this_thread::yield();
+    }
+
+    alignas(kLine) std::atomic<size_t> m_head{0};   // next item to pop, written by the consumer
+    size_t m_cachedTail = 0;                        // consumer's copy of m_tail
+    alignas(kLine) std::atomic<size_t> m_tail{0};   // next free slot, written by the producer
+    size_t m_cachedHead = 0;                        // producer's copy of m_head
+    alignas(kLine) std::array<T, Capacity> m_items;
+};
+
+}
@@ -0,0 +1,66 @@
+#include "Stats.hpp"
+#include "Club.hpp"
+#include <bit>
+
+namespace Yadro {
+
+void RunStats::addLatency(uint64_t nanos) {
+    size_t bucket = std::bit_width(nanos);
+    latency[bucket < kLatencyBuckets ? bucket : kLatencyBuckets - 1]++;
+}
+
+uint64_t RunStats::latencyPercentile(double fraction) const {
+    uint64_t total = 0;
+    for (uint64_t count : latency)
+        total += count;
+    if (total == 0)
+        return 0;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kLatencyBuckets; bucket++) {
+        seen += latency[bucket];
+        if (seen >= fraction * total)
+            return uint64_t(1) << bucket;
+    }
+    return uint64_t(1) << (kLatencyBuckets - 1);
+}
+
+void RunStats::writeJson(OutputSink &out) const {
+    out.line("{");
+    out.append("  \"events\": {");
+    for (int id = 1; id <= 4; id++)
+        out.append(id > 1 ? ", \"" : "\"").appendInt(id).append("\": ").appendInt(eventsById[id]);
+    out.line("},");
+    out.append("  \"errors\": {");
+    for (size_t error = 0; error < errors.size(); error++) {
+        out.append(error > 0 ? ", \"" : "\"").append(errorName(static_cast<ClubError>(error))).append("\": ");
+        out.appendInt(errors[error]);
+    }
+    out.line("},");
+    out.append("  \"clientsSentAway\": ").appendInt(clientsSentAway).line(",");
+    out.append("  \"queueOverflows\": ").appendInt(queueOverflows).line(",");
+    out.append("  \"seatedFromQueue\": ").appendInt(seatedFromQueue).line(",");
+    out.append("  \"tableTurnovers\": ").appendInt(tableTurnovers).line(",");
+    out.append("  \"peakQueue\": ").appendInt(peakQueue).line(",");
+    out.append("  \"peakClients\": ").appendInt(peakClients).line(",");
+    static constexpr const char *kPhaseNames[kPhases] = {"read", "parse", "process", "endOfDay", "report"};
+    out.append("  \"phaseNanos\": {");
+    for (size_t phase = 0; phase < kPhases; phase++)
+        out.append(phase > 0 ? ", \"" : "\"").append(kPhaseNames[phase]).append("\": ").appendInt(phaseNanos[phase]);
+    out.line("},");
+    // Only the buckets in use, keyed by their upper bound in nanoseconds
+    out.append("  \"latencyNanos\": {\"p50\": ").appendInt(latencyPercentile(0.5));
+    out.append(", \"p99\": ").appendInt(latencyPercentile(0.99));
+    out.append(", \"p999\": ").appendInt(latencyPercentile(0.999)).append(", \"buckets\": {");
+    bool first = true;
+    for (size_t bucket = 0; bucket < kLatencyBuckets; bucket++) {
+        if (latency[bucket] == 0)
+            continue;
+        out.append(first ? "\"" : ", \"").appendInt(static_cast<long long>(uint64_t(1) << bucket)).append("\": ");
+        out.appendInt(latency[bucket]);
+        first = false;
+    }
+    out.line("}}");
+    out.line("}");
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "OutputSink.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Yadro {
+
+// Counters and timings of one run. They are filled only when a RunStats is
+// passed in, so a run without stats pays one null pointer check per event.
+struct RunStats {
+    enum Phase { Read, Parse, Process, EndOfDay, Report, kPhases };
+    // Bucket i counts events processed in [2^(i-1), 2^i) nanoseconds
+    static constexpr size_t kLatencyBuckets = 40;
+
+    std::array<uint64_t, 5> eventsById{};  // input events 1-4, index 0 unused
+    std::array<uint64_t, 6> errors{};      // events 13 by ClubError
+    uint64_t clientsSentAway = 0;          // events 11
+    uint64_t queueOverflows = 0;           // events 11 of a client who found the queue full
+    uint64_t seatedFromQueue = 0;          // events 12
+    uint64_t tableTurnovers = 0;           // times a free table was taken
+    size_t peakQueue = 0;
+    int clientsInClub = 0;
+    int peakClients = 0;
+    std::array<uint64_t, kPhases> phaseNanos{};
+    std::array<uint64_t, kLatencyBuckets> latency{};
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    void addLatency(uint64_t nanos);
+    // Smallest bucket bound that at least fraction of the events stay under, in ns
+    uint64_t latencyPercentile(double fraction) const;
+    void writeJson(OutputSink &out) const;
+};
+
+// Adds the wall time from construction to destruction to a phase; does nothing without stats.
+class PhaseTimer {
+public:
+    PhaseTimer(RunStats *stats, RunStats::Phase phase)
+        : m_stats(stats), m_phase(phase), m_start(stats != nullptr ? RunStats::now() : 0) {}
+    ~PhaseTimer() {
+        if (m_stats != nullptr)
+            m_stats->phaseNanos[m_phase] += RunStats::now() - m_start;
+    }
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+private:
+    RunStats *m_stats;
+    RunStats::Phase m_phase;
+    uint64_t m_start;
+};
+
+}
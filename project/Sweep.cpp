@@ -0,0 +1,199 @@
+#include "Sweep.hpp"
+#include "Club.hpp"
+#include "DayArena.hpp"
+#include "ThreadPool.hpp"
+#include "Time.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace Yadro {
+
+namespace {
+
+// A variants line can not ask for more configurations than this.
+constexpr size_t kMaxVariants = 1 << 20;
+// Variants replayed by one pool task
+constexpr size_t kVariantsPerTask = 16;
+
+std::optional<int> fieldValue(std::string_view text, bool isTime) {
+    return isTime ? Time::FromString(text) : Util::FromString(text);
+}
+
+// Values of one field of a variants line: "*", a comma list, or for numbers also
+// "from..to" and "from..to/step" items.
+bool expandField(std::string_view field, int base, bool isTime, std::vector<int> &values) {
+    if (field == "*") {
+        values.push_back(base);
+        return true;
+    }
+    while (true) {
+        size_t comma = field.find(',');
+        std::string_view item = field.substr(0, comma);
+        size_t dots = item.find("..");
+        if (isTime || dots == std::string_view::npos) {
+            auto value = fieldValue(item, isTime);
+            if (!value.has_value())
+                return false;
+            values.push_back(value.value());
+        } else {
+            std::string_view to = item.substr(dots + 2);
+            std::optional<int> step = 1;
+            size_t slash = to.find('/');
+            if (slash != std::string_view::npos) {
+                step = Util::FromString(to.substr(slash + 1));
+                to = to.substr(0, slash);
+            }
+            auto first = Util::FromString(item.substr(0, dots));
+            auto last = Util::FromString(to);
+            if (!first.has_value() || !last.has_value() || !step.has_value() || step.value() <= 0
+                || first.value() > last.value()
+                || (static_cast<long long>(last.value()) - first.value()) / step.value() >= static_cast<long long>(kMaxVariants))
+                return false;
+            for (long long value = first.value(); value <= last.value(); value += step.value())
+                values.push_back(static_cast<int>(value));
+        }
+        if (comma == std::string_view::npos)
+            return true;
+        field.remove_prefix(comma + 1);
+    }
+}
+
+}
+
+bool ParsedDay::load(const std::string &filename, std::string &errorLine) {
+    Parser parser(filename);
+    if (!parser.ReadConfig(m_config, errorLine))
+        return false;
+    EventView event;
+    while (parser.NextEvent(event, errorLine)) {
+        ClientId client = m_names.intern(event.clientName);
+        m_events.push_back({client, event.tableNumber, static_cast<int16_t>(event.time), static_cast<uint8_t>(event.eventId)});
+        m_maxTable = std::max(m_maxTable, event.tableNumber);
+    }
+    return !parser.Failed();
+}
+
+SweepResult ParsedDay::replay(const ClubConfig &variant) const {
+    SweepResult result;
+    result.config = variant;
+    if (variant.numTables < m_maxTable)
+        return result;
+    // Variants run back to back on a worker reuse its arena instead of the heap.
+    thread_local DayArena arena;
+    {
+        RunStats stats;
+        Club club(variant.numTables, variant.openTime, variant.closeTime, variant.hourlyCost, &m_names,
+                  arena.resource());
+        club.setOutputMode(OutputMode::Summary);
+        club.setStats(&stats);
+        for (const Event &event : m_events)
+            club.processEvent(EventView{event.time, event.eventId, event.table, {}, {}}, event.client);
+        club.endOfDay();
+        for (const auto &table : club.getTables()) {
+            result.revenue += table.revenue;
+            result.occupied += table.totalOccupied;
+        }
+        result.sentAway = stats.clientsSentAway;
+    }
+    arena.reset();
+    result.accepted = true;
+    result.utilization = static_cast<double>(result.occupied)
+        / (static_cast<double>(variant.numTables) * (variant.closeTime - variant.openTime));
+    return result;
+}
+
+uint64_t ParsedDay::queueOverflows(int tablesCount, uint64_t budget) const {
+    thread_local DayArena arena;
+    uint64_t overflows = 0;
+    {
+        RunStats stats;
+        Club club(tablesCount, m_config.openTime, m_config.closeTime, m_config.hourlyCost, &m_names, arena.resource());
+        club.setOutputMode(OutputMode::Summary);
+        club.setStats(&stats);
+        for (const Event &event : m_events) {
+            club.processEvent(EventView{event.time, event.eventId, event.table, {}, {}}, event.client);
+            // Only an event 3 can overflow the queue.
+            if (event.eventId == 3 && stats.queueOverflows > budget)
+                break;
+        }
+        overflows = stats.queueOverflows;
+    }
+    arena.reset();
+    return overflows;
+}
+
+CapacityResult solveMinTables(const ParsedDay &day, uint64_t budget) {
+    int low = day.minTables();
+    int high = day.maxUsefulTables();
+    CapacityResult result{high, 0, 0};
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        uint64_t overflows = day.queueOverflows(middle, budget);
+        result.simulations++;
+        if (overflows <= budget) {
+            high = middle;
+            result = {middle, overflows, result.simulations};
+        } else {
+            low = middle + 1;
+        }
+    }
+    return result;
+}
+
+bool expandVariants(std::string_view line, const ClubConfig &base, std::vector<ClubConfig> &variants) {
+    Util::Tokens tokens = Util::splitString(line);
+    if (tokens.size() == 0)
+        return true;
+    std::vector<int> tables, opens, closes, costs;
+    if (tokens.size() != 4 || !expandField(tokens[0], base.numTables, false, tables)
+        || !expandField(tokens[1], base.openTime, true, opens) || !expandField(tokens[2], base.closeTime, true, closes)
+        || !expandField(tokens[3], base.hourlyCost, false, costs))
+        return false;
+    if (tables.size() * opens.size() * closes.size() * costs.size() > kMaxVariants)
+        return false;
+    for (int numTables : tables) {
+        for (int openTime : opens) {
+            for (int closeTime : closes) {
+                for (int hourlyCost : costs) {
+                    if (numTables <= 0 || hourlyCost <= 0 || openTime >= closeTime)
+                        return false;
+                    variants.push_back({openTime, closeTime, numTables, hourlyCost});
+                }
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<SweepResult> runSweep(const ParsedDay &day, const std::vector<ClubConfig> &variants, unsigned jobs) {
+    std::vector<SweepResult> results(variants.size());
+    ThreadPool pool(jobs);
+    for (size_t begin = 0; begin < variants.size(); begin += kVariantsPerTask) {
+        size_t end = std::min(begin + kVariantsPerTask, variants.size());
+        pool.submit([&day, &variants, &results, begin, end] {
+            for (size_t i = begin; i < end; i++)
+                results[i] = day.replay(variants[i]);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+void writeSweep(const std::vector<SweepResult> &results, OutputSink &out) {
+    for (const auto &result : results) {
+        const ClubConfig &config = result.config;
+        out.appendInt(config.numTables).appendChar(' ').appendTime(config.openTime).appendChar(' ')
+            .appendTime(config.closeTime).appendChar(' ').appendInt(config.hourlyCost).appendChar(' ');
+        if (!result.accepted) {
+            out.line("rejected");
+            continue;
+        }
+        long long tenths = std::llround(result.utilization * 1000);
+        out.appendInt(result.revenue).appendChar(' ').appendInt(static_cast<long long>(result.sentAway)).appendChar(' ')
+            .appendInt(tenths / 10).appendChar('.').appendInt(tenths % 10).appendChar('%').endLine();
+    }
+}
+
+}
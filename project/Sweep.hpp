@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Parser.hpp"
+#include "ClientNames.hpp"
+#include "OutputSink.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Yadro {
+
+// Outcome of one club configuration over the events of a day
+struct SweepResult {
+    ClubConfig config;
+    bool accepted = false;      // false if an event names a table the variant does not have
+    long long revenue = 0;
+    long long occupied = 0;     // minutes, over all tables
+    uint64_t sentAway = 0;      // events 11
+    double utilization = 0;     // occupied share of tables * (closeTime - openTime)
+};
+
+// Events of one input file, parsed once and replayed under other configurations.
+// Immutable after load(), so any number of threads can replay it at once.
+class ParsedDay {
+public:
+    // False with errorLine set if the file is rejected, as in the file mode.
+    bool load(const std::string &filename, std::string &errorLine);
+    const ClubConfig &config() const { return m_config; }
+    size_t size() const { return m_events.size(); }
+    // Run the day with the configuration of variant instead of the one of the file.
+    SweepResult replay(const ClubConfig &variant) const;
+    // Events 11 of clients who found the queue full when the day runs with tablesCount
+    // tables. The run stops as soon as there are more than budget of them.
+    uint64_t queueOverflows(int tablesCount, uint64_t budget) const;
+    // Fewest tables the events can run with
+    int minTables() const { return std::max(m_maxTable, 1); }
+    // Enough tables for nobody to wait: a table no event asks for is only taken from the
+    // queue, and the queue only forms when every table is taken.
+    int maxUsefulTables() const { return minTables() + 1; }
+private:
+    // Only what the club state needs: the line and the name are left behind.
+    struct Event {
+        ClientId client;
+        int32_t table;    // -1 unless eventId == 2
+        int16_t time;
+        uint8_t eventId;
+    };
+    ClubConfig m_config{};
+    // Clubs get it read-only: every event comes with its client id.
+    ClientNames m_names;
+    std::vector<Event> m_events;
+    int m_maxTable = 0;
+};
+
+// Expand one line of a variants file into configurations. Each of the four fields
+// "<tables> <open> <close> <cost>" is "*" (the value of base), a comma list, and
+// for tables and cost also "from..to" or "from..to/step"; the result is the cross
+// product. Returns false if the line is bad; an empty line gives nothing.
+bool expandVariants(std::string_view line, const ClubConfig &base, std::vector<ClubConfig> &variants);
+
+struct CapacityResult {
+    int tablesCount;      // the smallest table count that meets the budget
+    uint64_t overflows;   // queue overflows with that many tables
+    int simulations;      // days replayed to find it
+};
+
+// Smallest number of tables for which the day has at most budget queue overflows,
+// the other settings as in the input. Binary search over [minTables, maxUsefulTables]:
+// more tables never make the queue overflow more often, so O(log T) replays are
+// enough, and each replay stops once it is over the budget.
+CapacityResult solveMinTables(const ParsedDay &day, uint64_t budget);
+
+// Replay day under every variant on jobs threads (0 means one per core).
+std::vector<SweepResult> runSweep(const ParsedDay &day, const std::vector<ClubConfig> &variants, unsigned jobs);
+
+// One line per result, in order: "<tables> <open> <close> <cost> <revenue> <sent away>
+// <utilization>%", or "<tables> <open> <close> <cost> rejected".
+void writeSweep(const std::vector<SweepResult> &results, OutputSink &out);
+
+}
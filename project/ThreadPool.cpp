@@ -0,0 +1,104 @@
+#include "ThreadPool.hpp"
+
+namespace Yadro {
+
+namespace {
+// Queue of the worker running on this thread, so nested submits stay local
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local unsigned currentWorker = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    for (unsigned i = 0; i < threads; i++)
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    for (unsigned i = 0; i < threads; i++)
+        m_threads.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    unsigned index = currentPool == this
+        ? currentWorker
+        : static_cast<unsigned>(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+    // Counted before it is queued, so the task cannot finish first.
+    m_pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+        m_queued.fetch_add(1);
+    }
+    // A worker going to sleep counts itself before it looks at m_queued, so either it
+    // sees this task or it is counted here and gets the notification.
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_pending.load() == 0; });
+}
+
+bool ThreadPool::takeTask(unsigned index, std::function<void()> &task) {
+    {
+        TaskQueue &own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t step = 1; step < m_queues.size(); step++) {
+        TaskQueue &other = *m_queues[(index + step) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned index) {
+    currentPool = this;
+    currentWorker = index;
+    std::function<void()> task;
+    while (true) {
+        if (!takeTask(index, task)) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleeping.fetch_add(1);
+            m_wake.wait(lock, [this] { return m_stop || m_queued.load() > 0; });
+            m_sleeping.fetch_sub(1);
+            if (m_stop && m_queued.load() == 0)
+                return;
+            continue;
+        }
+        task();
+        task = nullptr;
+        if (m_pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_idle.notify_all();
+        }
+    }
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Yadro {
+
+// Fixed set of worker threads, each with its own task deque. A worker runs its
+// own tasks newest first and steals the oldest tasks of the others when idle.
+// Taking a task locks only the deque it comes from; the pool lock is taken only
+// to put a worker to sleep, to wake one, and when the last pending task ends.
+class ThreadPool {
+public:
+    // threads == 0 means one thread per core
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task);
+    // Block until every submitted task has finished
+    void wait();
+    unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;                 // guards m_stop and the sleeping and waiting
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::atomic<size_t> m_queued{0};    // tasks in the deques, changed under their locks
+    std::atomic<size_t> m_pending{0};   // tasks submitted and not finished
+    std::atomic<size_t> m_sleeping{0};  // workers waiting on m_wake
+    std::atomic<size_t> m_nextQueue{0};
+    bool m_stop = false;
+
+    void run(unsigned index);
+    bool takeTask(unsigned index, std::function<void()> &task);
+};
+
+}
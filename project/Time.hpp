@@ -1,11 +1,10 @@
 #pragma once
 
 #include <string>
-#include <iomanip>
-#include <sstream>
+#include <charconv>
 #include <optional>
 #include <string_view>
-#include <cstdlib>
+#include "Utils.hpp"
 
 
 namespace Yadro {
@@ -14,31 +13,44 @@ namespace Time {
 inline std::optional<int> FromString(std::string_view timeStr) {
     if (timeStr.size() != 5 || timeStr[2] != ':')
         return std::nullopt;
-    
-    std::string hoursStr{timeStr.substr(0, 2)};
-    std::string minutesStr{timeStr.substr(3, 2)};
-    
-    char* endPtr = nullptr;
-    long hours = std::strtol(hoursStr.c_str(), &endPtr, 10);
-    if (*endPtr != '\0')
+
+    auto maybeHours = Util::FromString(timeStr.substr(0, 2));
+    if (!maybeHours.has_value())
         return std::nullopt;
-    endPtr = nullptr;
-    long minutes = std::strtol(minutesStr.c_str(), &endPtr, 10);
-    if (*endPtr != '\0')
+    auto maybeMinutes = Util::FromString(timeStr.substr(3, 2));
+    if (!maybeMinutes.has_value())
         return std::nullopt;
+    int hours = maybeHours.value();
+    int minutes = maybeMinutes.value();
     if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59)
         return std::nullopt;
-    return static_cast<int>(hours * 60 + minutes);
+    return hours * 60 + minutes;
 }
     
-inline std::string ToString(int totalMinutes) {
+// Longest text Format can produce
+constexpr size_t kMaxLength = 16;
+
+// Write minutes as "HH:MM" into out (kMaxLength bytes), return the length.
+inline size_t Format(int totalMinutes, char *out) {
     int hours = totalMinutes / 60;
     int minutes = totalMinutes % 60;
-    std::ostringstream oss;
-    oss << std::setw(2) << std::setfill('0') << hours << ":"
-        << std::setw(2) << std::setfill('0') << minutes;
-    return oss.str();
+    size_t length = 0;
+    if (hours >= 0 && hours < 100) {
+        out[length++] = static_cast<char>('0' + hours / 10);
+        out[length++] = static_cast<char>('0' + hours % 10);
+    } else {
+        length = std::to_chars(out, out + kMaxLength, hours).ptr - out;
+    }
+    out[length++] = ':';
+    out[length++] = static_cast<char>('0' + minutes / 10);
+    out[length++] = static_cast<char>('0' + minutes % 10);
+    return length;
 }
 
+inline std::string ToString(int totalMinutes) {
+    char text[kMaxLength];
+    return std::string(text, Format(totalMinutes, text));
+}
+
+}
 }
-}
\ No newline at end of file
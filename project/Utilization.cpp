@@ -0,0 +1,84 @@
+#include "Utilization.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace Yadro {
+
+namespace {
+
+void writeBucketLine(OutputSink &out, int time, int64_t revenue, int64_t occupied) {
+    out.appendChar(' ').appendTime(time).appendChar(' ').appendInt(revenue).appendChar(' ')
+        .appendTime(static_cast<int>(occupied)).endLine();
+}
+
+}
+
+void writeUtilization(std::span<const Session> sessions, const ClubConfig &config, int bucketMinutes,
+                      OutputSink &out) {
+    const int day = config.closeTime - config.openTime;
+    const size_t buckets = (day + bucketMinutes - 1) / bucketMinutes;
+    if (buckets == 0)
+        return;
+
+    // Group the sessions by table with a counting sort.
+    std::vector<size_t> tableBegin(config.numTables + 1, 0);
+    for (const auto &session : sessions)
+        tableBegin[session.table]++;
+    for (int table = 1; table <= config.numTables; table++)
+        tableBegin[table] += tableBegin[table - 1];
+    std::vector<size_t> next(tableBegin.begin(), tableBegin.end() - 1);
+    std::vector<const Session *> byTable(sessions.size());
+    for (const auto &session : sessions)
+        byTable[next[session.table - 1]++] = &session;
+
+    // Minutes in the first and last bucket of a session go straight into partial;
+    // the buckets it covers whole are counted with a difference array.
+    std::vector<int64_t> partial(buckets);
+    std::vector<int32_t> whole(buckets + 1);
+    std::vector<int64_t> revenue(buckets);
+    std::vector<int64_t> totalOccupied(buckets, 0);
+    std::vector<int64_t> totalRevenue(buckets, 0);
+    for (int table = 1; table <= config.numTables; table++) {
+        std::fill(partial.begin(), partial.end(), 0);
+        std::fill(whole.begin(), whole.end(), 0);
+        std::fill(revenue.begin(), revenue.end(), 0);
+        for (size_t i = tableBegin[table - 1]; i < tableBegin[table]; i++) {
+            const Session &session = *byTable[i];
+            int duration = session.end - session.start;
+            int paid = ((duration + 59) / 60) * config.hourlyCost;
+            int endBucket = std::clamp((session.end - config.openTime) / bucketMinutes, 0, static_cast<int>(buckets) - 1);
+            revenue[endBucket] += paid;
+
+            int start = std::max(session.start, config.openTime) - config.openTime;
+            int end = std::min(session.end, config.closeTime) - config.openTime;
+            if (end <= start)
+                continue;
+            size_t first = start / bucketMinutes;
+            size_t last = (end - 1) / bucketMinutes;
+            if (first == last) {
+                partial[first] += end - start;
+                continue;
+            }
+            partial[first] += static_cast<int64_t>(first + 1) * bucketMinutes - start;
+            partial[last] += end - static_cast<int64_t>(last) * bucketMinutes;
+            whole[first + 1]++;
+            whole[last]--;
+        }
+        int64_t covering = 0;
+        for (size_t bucket = 0; bucket < buckets; bucket++) {
+            covering += whole[bucket];
+            int64_t occupied = partial[bucket] + covering * bucketMinutes;
+            totalOccupied[bucket] += occupied;
+            totalRevenue[bucket] += revenue[bucket];
+            out.appendInt(table);
+            writeBucketLine(out, config.openTime + static_cast<int>(bucket) * bucketMinutes, revenue[bucket], occupied);
+        }
+    }
+    for (size_t bucket = 0; bucket < buckets; bucket++) {
+        out.append("total");
+        writeBucketLine(out, config.openTime + static_cast<int>(bucket) * bucketMinutes, totalRevenue[bucket],
+                        totalOccupied[bucket]);
+    }
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Parser.hpp"
+#include "SessionIndex.hpp"
+#include "OutputSink.hpp"
+#include <span>
+
+namespace Yadro {
+
+// Bucketed utilization report of a finished day, from the sessions the club recorded.
+// The day from openTime to closeTime is cut into buckets of bucketMinutes (the last one
+// may be shorter). For every table, then for the whole club, one line per bucket:
+//   <table> <bucket start> <revenue> <occupied time>
+// with "total" in place of the table number for the club. Occupied time is clipped
+// to the day; the revenue of a session goes to the bucket in which it ended.
+// Runs in O(sessions + tables * buckets) time with O(sessions + buckets) memory.
+void writeUtilization(std::span<const Session> sessions, const ClubConfig &config, int bucketMinutes,
+                      OutputSink &out);
+
+}
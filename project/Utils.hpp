@@ -1,31 +1,68 @@
 #pragma once
 
-#include <string>
-#include <vector>
-#include <sstream>
+#include <array>
+#include <charconv>
+#include <string_view>
 #include <optional>
-#include <cstdlib>
 
 namespace Yadro {
 namespace Util {
-    
-std::vector<std::string> splitString(const std::string &str) {
+
+// Tokens of one line, viewing into the line itself. Only the first kMaxTokens
+// are kept, but size() is the real number of tokens in the line.
+struct Tokens {
+    static constexpr size_t kMaxTokens = 4;
+    std::array<std::string_view, kMaxTokens> items;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    std::string_view operator[](size_t index) const { return items[index]; }
+};
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+inline Tokens splitString(std::string_view str) {
     // split string for tokens by spaces
-    std::istringstream inputStream(str);
-    std::vector<std::string> tokens;
-    std::string token;
-    while (inputStream >> token)
-        tokens.push_back(token);
+    Tokens tokens;
+    size_t pos = 0;
+    while (true) {
+        while (pos < str.size() && isSpace(str[pos]))
+            pos++;
+        if (pos == str.size())
+            break;
+        size_t start = pos;
+        while (pos < str.size() && !isSpace(str[pos]))
+            pos++;
+        if (tokens.count < Tokens::kMaxTokens)
+            tokens.items[tokens.count] = str.substr(start, pos - start);
+        tokens.count++;
+    }
     return tokens;
 }
 
-inline std::optional<int> FromString(const std::string &str) {
-    char* endPtr = nullptr;
-    long value = std::strtol(str.c_str(), &endPtr, 10);
-    if (*endPtr != '\0')
+inline std::optional<int> FromString(std::string_view str) {
+    // Same rules as strtol over the whole string: leading spaces and a sign are allowed
+    if (str.empty())
+        return 0;
+    size_t pos = 0;
+    while (pos < str.size() && isSpace(str[pos]))
+        pos++;
+    bool negative = false;
+    if (pos < str.size() && (str[pos] == '+' || str[pos] == '-')) {
+        negative = str[pos] == '-';
+        pos++;
+    }
+    if (pos == str.size() || str[pos] < '0' || str[pos] > '9')
+        return std::nullopt;
+    int value = 0;
+    const char *end = str.data() + str.size();
+    auto [ptr, ec] = std::from_chars(str.data() + pos, end, value);
+    if (ec != std::errc() || ptr != end)
         return std::nullopt;
-    return static_cast<int>(value);
+    return negative ? -value : value;
 }
 
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ClientNames.hpp"
+#include <memory_resource>
+#include <vector>
+
+namespace Yadro {
+
+// FIFO of waiting clients as an intrusive doubly linked list over id-indexed
+// arrays: push, pop, membership test and removal from the middle are all O(1).
+class WaitingQueue {
+public:
+    explicit WaitingQueue(std::pmr::memory_resource *memory = std::pmr::get_default_resource()) : m_links(memory) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    ClientId front() const { return m_head; }
+
+    bool contains(ClientId client) const {
+        return client < static_cast<ClientId>(m_links.size()) && m_links[client].queued;
+    }
+
+    // Append client to the back; a client already in the queue keeps its place.
+    void push(ClientId client) {
+        if (client >= static_cast<ClientId>(m_links.size()))
+            m_links.resize(client + 1);
+        Link &link = m_links[client];
+        if (link.queued)
+            return;
+        link.queued = true;
+        link.prev = m_tail;
+        link.next = kNoClient;
+        if (m_tail != kNoClient)
+            m_links[m_tail].next = client;
+        else
+            m_head = client;
+        m_tail = client;
+        m_size++;
+    }
+
+    // Remove client wherever it is in the queue; does nothing if it is not queued.
+    void remove(ClientId client) {
+        if (!contains(client))
+            return;
+        Link &link = m_links[client];
+        if (link.prev != kNoClient)
+            m_links[link.prev].next = link.next;
+        else
+            m_head = link.next;
+        if (link.next != kNoClient)
+            m_links[link.next].prev = link.prev;
+        else
+            m_tail = link.prev;
+        link = Link();
+        m_size--;
+    }
+
+    ClientId pop() {
+        ClientId client = m_head;
+        remove(client);
+        return client;
+    }
+
+    // Call visit(client) for every queued client from the front to the back.
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (ClientId client = m_head; client != kNoClient; client = m_links[client].next)
+            visit(client);
+    }
+
+private:
+    struct Link {
+        ClientId prev = kNoClient;
+        ClientId next = kNoClient;
+        bool queued = false;
+    };
+    std::pmr::vector<Link> m_links;
+    ClientId m_head = kNoClient;
+    ClientId m_tail = kNoClient;
+    size_t m_size = 0;
+};
+
+}
@@ -1,53 +1,477 @@
-#include "Club.hpp"
-#include "Parser.hpp"
+#include "Batch.hpp"
+#include "Runner.hpp"
+#include "Sharded.hpp"
+#include "EventLog.hpp"
+#include "Sweep.hpp"
+#include "Server.hpp"
+#include "Pipeline.hpp"
+#include "MappedFile.hpp"
+#include "Stats.hpp"
+#include "OutputSink.hpp"
+#include "Utils.hpp"
 #include <iostream>
-#include <vector>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
 
+namespace {
 
-int main(int argc, char* argv[]) {
+void printUsage(const char *program) {
+    std::cerr << "Usage: " << program << " [--jobs <n>] [--stats <json_file>] [--output <mode>] <input_file>\n"
+              << "       " << program << " --pipeline [--output <mode>] <input_file>\n"
+              << "       " << program << " --online [--checkpoint <file>] [--checkpoint-every <n>] [--resume <file>] [<input_file>]\n"
+              << "       " << program << " --convert <input_file> <log_file>\n"
+              << "       " << program << " --replay <log_file>\n"
+              << "       " << program << " --query <input_file> < queries\n"
+              << "       " << program << " --utilization <bucket_minutes> <input_file>\n"
+              << "       " << program << " --batch [--out-dir <dir>] [--jobs <n>] [--output <mode>] <file|dir|@manifest>...\n"
+              << "       " << program << " --sharded [--out-dir <dir>] [--jobs <n>] <combined_file>\n"
+              << "       " << program << " --sweep [--jobs <n>] <input_file> <variants_file>\n"
+              << "       " << program << " --min-tables [--max-overflows <k>] <input_file>\n"
+              << "       " << program << " --serve [--jobs <n>] <socket_path>\n"
+              << "Output modes: full (default), report, errors, summary" << std::endl;
+}
+
+bool parseOutputMode(std::string_view name, Yadro::OutputMode &mode) {
+    using Yadro::OutputMode;
+    if (name == "full")
+        mode = OutputMode::Full;
+    else if (name == "report")
+        mode = OutputMode::ReportOnly;
+    else if (name == "errors")
+        mode = OutputMode::ErrorsOnly;
+    else if (name == "summary")
+        mode = OutputMode::Summary;
+    else
+        return false;
+    return true;
+}
+
+// Options shared by the multi-file modes; the remaining arguments are the inputs.
+struct CommonOptions {
+    std::string outputDir = ".";
+    unsigned jobs = 0;
+    Yadro::OutputMode outputMode = Yadro::OutputMode::Full;
+    std::vector<std::string> inputs;
+};
+
+bool parseCommonOptions(int argc, char* argv[], CommonOptions &options) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--out-dir" && i + 1 < argc) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            auto maybeJobs = Yadro::Util::FromString(argv[++i]);
+            if (!maybeJobs.has_value() || maybeJobs.value() < 0)
+                return false;
+            options.jobs = maybeJobs.value();
+        } else if (arg == "--output" && i + 1 < argc) {
+            if (!parseOutputMode(argv[++i], options.outputMode))
+                return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return !options.inputs.empty();
+}
+
+// Counters and timings of the run as JSON; "-" writes them to stderr.
+bool writeStats(const Yadro::RunStats &stats, const std::string &filename) {
+    using namespace Yadro;
+    int fd = filename == "-" ? STDERR_FILENO : ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+    bool written;
+    {
+        FdSink out(fd);
+        stats.writeJson(out);
+        out.flush();
+        written = out.good();
+    }
+    if (fd != STDERR_FILENO && ::close(fd) != 0)
+        written = false;
+    if (!written)
+        std::cerr << "Error: Cannot write file " << filename << std::endl;
+    return written;
+}
+
+int batchMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    CommonOptions common;
+    if (!parseCommonOptions(argc, argv, common)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    BatchOptions options;
+    options.inputs = common.inputs;
+    options.outputDir = common.outputDir;
+    options.jobs = common.jobs;
+    options.outputMode = common.outputMode;
+    std::vector<std::string> errors;
+    int failed = runBatch(options, errors);
+    for (const auto &error : errors)
+        std::cerr << error << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+int shardedMain(int argc, char* argv[]) {
     using namespace Yadro;
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+    CommonOptions common;
+    if (!parseCommonOptions(argc, argv, common) || common.inputs.size() != 1
+        || common.outputMode != OutputMode::Full) {
+        printUsage(argv[0]);
         return 1;
     }
-    
-    std::string filename = argv[1];
-    Parser parser(filename);
-    ClubConfig config;
-    std::vector<EventData> events;
+    ShardedOptions options;
+    options.input = common.inputs[0];
+    options.outputDir = common.outputDir;
+    options.jobs = common.jobs;
+    std::vector<ClubSummary> summary;
+    std::vector<std::string> errors;
+    bool ok = runSharded(options, summary, errors);
+    for (const auto &error : errors)
+        std::cerr << error << std::endl;
+
+    // Merged summary: one line per club, then the totals over accepted clubs.
+    FdSink out(STDOUT_FILENO);
+    long long totalRevenue = 0;
+    long long totalOccupied = 0;
+    for (const auto &club : summary) {
+        out.append(club.clubId).appendChar(' ');
+        if (!club.accepted) {
+            out.line("rejected");
+            continue;
+        }
+        out.appendInt(club.revenue).appendChar(' ').appendTime(static_cast<int>(club.occupied)).endLine();
+        totalRevenue += club.revenue;
+        totalOccupied += club.occupied;
+    }
+    out.append("total ").appendInt(totalRevenue).appendChar(' ').appendTime(static_cast<int>(totalOccupied)).endLine();
+    out.flush();
+    return ok && out.good() ? 0 : 1;
+}
+
+int sweepMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    CommonOptions common;
+    if (!parseCommonOptions(argc, argv, common) || common.inputs.size() != 2
+        || common.outputMode != OutputMode::Full) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    ParsedDay day;
     std::string errorLine;
-    if (!parser.ExecuteLines(config, events, errorLine)) {
-        // Output the first line with the error and terminate the program.
+    if (!day.load(common.inputs[0], errorLine)) {
         std::cout << errorLine << std::endl;
-        return 0;
+        return 1;
+    }
+    MappedFile file;
+    if (!file.open(common.inputs[1])) {
+        std::cerr << "Error: Cannot open file " << common.inputs[1] << std::endl;
+        return 1;
+    }
+    std::vector<ClubConfig> variants;
+    std::string_view lines = file.data();
+    while (!lines.empty()) {
+        size_t end = lines.find('\n');
+        std::string_view line = lines.substr(0, end);
+        lines.remove_prefix(end == std::string_view::npos ? lines.size() : end + 1);
+        if (!expandVariants(line, day.config(), variants)) {
+            std::cerr << "Error: Bad variant line: " << line << std::endl;
+            return 1;
+        }
     }
 
-    Club club(config.numTables, config.openTime, config.closeTime, config.hourlyCost);
+    FdSink out(STDOUT_FILENO);
+    writeSweep(runSweep(day, variants, common.jobs), out);
+    out.flush();
+    return out.good() ? 0 : 1;
+}
 
-    std::vector<std::string> output;
-    output.push_back(club.getOpenTimeStr());
-    for (const auto &event : events) {
-        club.processEvent(event);
+int minTablesMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    long long budget = 0;
+    std::string input;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--max-overflows" && i + 1 < argc) {
+            auto maybeBudget = Util::FromString(argv[++i]);
+            if (!maybeBudget.has_value() || maybeBudget.value() < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            budget = maybeBudget.value();
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
     }
+    if (input.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    ParsedDay day;
+    std::string errorLine;
+    if (!day.load(input, errorLine)) {
+        std::cout << errorLine << std::endl;
+        return 1;
+    }
+    CapacityResult result = solveMinTables(day, static_cast<uint64_t>(budget));
+    FdSink out(STDOUT_FILENO);
+    out.appendInt(result.tablesCount).appendChar(' ').appendInt(static_cast<long long>(result.overflows)).endLine();
+    out.flush();
+    return out.good() ? 0 : 1;
+}
 
-    club.endOfDay();
-    // Now we have all the events processed and the output is ready.
-    const std::vector<std::string> &eventOutputs = club.getOutput();
-    for (const auto &line : eventOutputs) {
-        output.push_back(line);
+int onlineMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    OnlineOptions options;
+    std::string input;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpointPath = argv[++i];
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            auto maybeEvery = Util::FromString(argv[++i]);
+            if (!maybeEvery.has_value() || maybeEvery.value() <= 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.checkpointEvery = maybeEvery.value();
+        } else if (arg == "--resume" && i + 1 < argc) {
+            options.resumePath = argv[++i];
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    // Standard input by default; a named pipe or a file can be given instead.
+    int fd = STDIN_FILENO;
+    if (!input.empty()) {
+        fd = ::open(input.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error: Cannot open file " << input << std::endl;
+            return 1;
+        }
     }
-    output.push_back(club.getCloseTimeStr());
+    FdSink out(STDOUT_FILENO);
+    std::vector<std::string> errors;
+    bool accepted = runOnline(fd, out, options, errors);
+    for (const auto &error : errors)
+        std::cerr << error << std::endl;
+    if (fd != STDIN_FILENO)
+        ::close(fd);
+    return accepted && errors.empty() && out.good() ? 0 : 1;
+}
 
-    // Making the final report about the revenue.
-    std::vector<std::string> report = club.getReport();
-    for (const auto &line : report) {
-        output.push_back(line);
+int convertMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    if (argc != 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    int fd = ::open(argv[3], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create file " << argv[3] << std::endl;
+        return 1;
     }
+    std::string errorLine;
+    bool converted;
+    bool written;
+    {
+        FdSink out(fd);
+        converted = EventLog::convert(argv[2], out, errorLine);
+        out.flush();
+        written = out.good();
+    }
+    if (::close(fd) != 0)
+        written = false;
+    if (!converted) {
+        // Same line as the file mode prints; no log is left behind.
+        std::cerr << errorLine << std::endl;
+        ::unlink(argv[3]);
+        return 1;
+    }
+    if (!written) {
+        std::cerr << "Error: Cannot write file " << argv[3] << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int replayMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    if (argc != 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    FdSink out(STDOUT_FILENO);
+    std::string error;
+    if (!EventLog::replay(argv[2], out, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    out.flush();
+    return out.good() ? 0 : 1;
+}
+
+int queryMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    if (argc != 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    FdSink out(STDOUT_FILENO);
+    bool accepted = runSessionQueries(argv[2], STDIN_FILENO, out);
+    out.flush();
+    return accepted && out.good() ? 0 : 1;
+}
+
+int utilizationMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    auto bucketMinutes = argc == 4 ? Util::FromString(argv[2]) : std::nullopt;
+    if (!bucketMinutes.has_value() || bucketMinutes.value() <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    FdSink out(STDOUT_FILENO);
+    bool accepted = runUtilization(argv[3], bucketMinutes.value(), out);
+    out.flush();
+    return accepted && out.good() ? 0 : 1;
+}
+
+Yadro::ClubServer *runningServer = nullptr;
 
-    for (const auto &line : output) {
-        std::cout << line << std::endl;
+void stopServer(int) {
+    if (runningServer != nullptr)
+        runningServer->stop();
+}
+
+int serveMain(int argc, char* argv[]) {
+    using namespace Yadro;
+    unsigned jobs = 0;
+    std::string path;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            auto maybeJobs = Util::FromString(argv[++i]);
+            if (!maybeJobs.has_value() || maybeJobs.value() < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            jobs = maybeJobs.value();
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    ClubServer server(jobs);
+    std::string errorLine;
+    if (!server.listen(path, errorLine)) {
+        std::cerr << errorLine << std::endl;
+        return 1;
     }
-    
+    // SIGINT and SIGTERM stop the server; the socket file is removed on the way out.
+    runningServer = &server;
+    struct sigaction action {};
+    action.sa_handler = stopServer;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    server.run();
+    runningServer = nullptr;
     return 0;
-}
\ No newline at end of file
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    using namespace Yadro;
+    if (argc >= 2 && std::string(argv[1]) == "--batch")
+        return batchMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--sharded")
+        return shardedMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--sweep")
+        return sweepMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--min-tables")
+        return minTablesMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--serve")
+        return serveMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--online")
+        return onlineMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--convert")
+        return convertMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--replay")
+        return replayMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--query")
+        return queryMain(argc, argv);
+    if (argc >= 2 && std::string(argv[1]) == "--utilization")
+        return utilizationMain(argc, argv);
+    // Large files are parsed on every core unless --jobs says otherwise.
+    unsigned jobs = 0;
+    std::string statsFile;
+    OutputMode outputMode = OutputMode::Full;
+    bool pipeline = false;
+    bool jobsGiven = false;
+    std::string input;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--pipeline") {
+            pipeline = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            auto maybeJobs = Util::FromString(argv[++i]);
+            if (!maybeJobs.has_value() || maybeJobs.value() < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            jobs = maybeJobs.value();
+            jobsGiven = true;
+        } else if (arg == "--stats" && i + 1 < argc) {
+            statsFile = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            if (!parseOutputMode(argv[++i], outputMode)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    // The stages of the pipeline have their own threads, and are not timed.
+    if (input.empty() || (pipeline && (jobsGiven || !statsFile.empty()))) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FdSink out(STDOUT_FILENO);
+    if (pipeline) {
+        runPipelined(input, out, outputMode);
+        out.flush();
+        return out.good() ? 0 : 1;
+    }
+    RunStats stats;
+    runClubFile(input, out, jobs, statsFile.empty() ? nullptr : &stats, std::pmr::get_default_resource(), outputMode);
+    out.flush();
+    bool written = out.good();
+    if (!statsFile.empty() && !writeStats(stats, statsFile))
+        written = false;
+    return written ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#ifndef YADRO_H
+#define YADRO_H
+
+/* C interface of libyadro. A day is an opaque handle: run it from a buffer with
+ * yadro_run, or feed it piece by piece with yadro_stream_* and close it with
+ * yadro_stream_finish. Strings returned for a day live until yadro_free. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YADRO_API_VERSION 1
+
+/* What a day keeps and prints, see OutputMode */
+enum {
+    YADRO_OUTPUT_FULL = 0,
+    YADRO_OUTPUT_REPORT = 1,
+    YADRO_OUTPUT_ERRORS = 2,
+    YADRO_OUTPUT_SUMMARY = 3
+};
+
+typedef struct yadro_day yadro_day;
+
+typedef struct {
+    int time;              /* minutes since midnight */
+    int event_id;          /* 1-4 input event, 11-13 generated event */
+    const char *client;    /* "" for event 13 */
+    int table;             /* events 2 and 12, 0 otherwise */
+    const char *error;     /* event 13 only, "" otherwise */
+} yadro_event;
+
+typedef struct {
+    int number;
+    int revenue;
+    int occupied;          /* minutes */
+} yadro_table;
+
+/* YADRO_API_VERSION of the library actually loaded */
+int yadro_api_version(void);
+
+/* Run the day of a whole input file held in data. NULL only for an unknown mode or
+ * when the library fails, e.g. out of memory. */
+yadro_day *yadro_run(const char *data, size_t size, int mode);
+
+/* Start a day fed with yadro_stream_feed; lines may be split across calls.
+ * NULL as for yadro_run. */
+yadro_day *yadro_stream_open(int mode);
+/* 0 once the input was rejected, the library failed or the day was finished,
+ * 1 otherwise */
+int yadro_stream_feed(yadro_day *day, const char *data, size_t size);
+/* End of input. Afterwards the day can be read like one of yadro_run. */
+void yadro_stream_finish(yadro_day *day);
+
+/* 1 if the input was accepted, 0 if it was rejected or is not finished yet */
+int yadro_accepted(const yadro_day *day);
+/* First bad line of a rejected input, "" otherwise */
+const char *yadro_error_line(const yadro_day *day);
+/* Output exactly as the main program prints it */
+const char *yadro_output(const yadro_day *day, size_t *size);
+
+size_t yadro_event_count(const yadro_day *day);
+/* 0 if index is out of range */
+int yadro_event_at(const yadro_day *day, size_t index, yadro_event *event);
+size_t yadro_table_count(const yadro_day *day);
+int yadro_table_at(const yadro_day *day, size_t index, yadro_table *table);
+
+void yadro_free(yadro_day *day);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -25,4 +25,96 @@ for infile in "$INPUT_DIR"/*.in.txt; do
 done
 
 rm -f "$TEMP_OUT"
+
+# The batch mode must give the same outputs for all the files at once.
+BATCH_DIR=$(mktemp -d)
+echo "Running test: batch"
+$APP --batch --out-dir "$BATCH_DIR" "$INPUT_DIR"
+if diff -ru "$OUTPUT_DIR" "$BATCH_DIR" > /dev/null; then
+    echo "Test batch passed."
+else
+    echo "Test batch failed. Differences:"
+    diff -ru "$OUTPUT_DIR" "$BATCH_DIR"
+    fail=1
+fi
+rm -rf "$BATCH_DIR"
+
+# The online mode reads a pipe and must give the same outputs.
+for infile in "$INPUT_DIR"/*.in.txt; do
+    testname=$(basename "$infile" .in.txt)
+    echo "Running test: online $testname"
+    if cat "$infile" | $APP --online | diff -u "$OUTPUT_DIR/${testname}.out.txt" - > /dev/null; then
+        echo "Test online $testname passed."
+    else
+        echo "Test online $testname failed."
+        fail=1
+    fi
+done
+
+# The pipelined mode must give the same outputs.
+for infile in "$INPUT_DIR"/*.in.txt; do
+    testname=$(basename "$infile" .in.txt)
+    echo "Running test: pipeline $testname"
+    if $APP --pipeline "$infile" | diff -u "$OUTPUT_DIR/${testname}.out.txt" - > /dev/null; then
+        echo "Test pipeline $testname passed."
+    else
+        echo "Test pipeline $testname failed."
+        fail=1
+    fi
+done
+
+# A converted binary event log must replay to the same output; a bad input is not converted.
+LOG_FILE=$(mktemp)
+for infile in "$INPUT_DIR"/*.in.txt; do
+    testname=$(basename "$infile" .in.txt)
+    echo "Running test: replay $testname"
+    if $APP --convert "$infile" "$LOG_FILE" 2> /dev/null; then
+        replayed=$($APP --replay "$LOG_FILE")
+    else
+        replayed=$($APP "$infile")
+    fi
+    if [ "$replayed" == "$(cat "$OUTPUT_DIR/${testname}.out.txt")" ]; then
+        echo "Test replay $testname passed."
+    else
+        echo "Test replay $testname failed."
+        fail=1
+    fi
+done
+rm -f "$LOG_FILE"
+
+# Session queries over the day of test1.
+echo "Running test: query"
+answers=$(printf 'busy 12:40\ntable 1 12:40\noverlap 18:00 19:00\n' | $APP --query "$INPUT_DIR/test1.in.txt")
+if [ "$answers" == "$(printf '3\nclient4\n1\n3 client3 10:59 19:00')" ]; then
+    echo "Test query passed."
+else
+    echo "Test query failed."
+    fail=1
+fi
+
+# Generated files must be accepted, and with no error events requested the club reports none.
+GENERATOR=../tools/generate
+if [ -x "$GENERATOR" ]; then
+    echo "Running test: generator"
+    GEN_FILE=$(mktemp)
+    $GENERATOR --events 20000 --clients 200 --tables 8 --arrivals peak --error-rate 0 --seed 3 --output "$GEN_FILE"
+    if $APP "$GEN_FILE" | grep -q " 13 "; then
+        echo "Test generator failed: the generated file has error events."
+        fail=1
+    else
+        echo "Test generator passed."
+    fi
+
+    # A file of several parser chunks gives the same output when parsed in parallel.
+    echo "Running test: parallel parsing"
+    $GENERATOR --events 300000 --clients 2000 --tables 50 --seed 5 --output "$GEN_FILE"
+    if diff <($APP --jobs 1 "$GEN_FILE") <($APP --jobs 4 "$GEN_FILE") > /dev/null; then
+        echo "Test parallel parsing passed."
+    else
+        echo "Test parallel parsing failed."
+        fail=1
+    fi
+    rm -f "$GEN_FILE"
+fi
+
 exit $fail
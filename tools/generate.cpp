@@ -0,0 +1,380 @@
+// Synthetic workload generator: writes a club input file (table count, hours,
+// price, then events 1-4) that the parser accepts, for load testing.
+#include "OutputSink.hpp"
+#include "Time.hpp"
+#include "Utils.hpp"
+#include "WaitingQueue.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+using Yadro::FdSink;
+
+enum class Arrivals { Uniform, Peak, Poisson };
+
+struct Options {
+    long long events = 1000;
+    int clients = 100;
+    int tables = 10;
+    int openTime = 9 * 60;
+    int closeTime = 21 * 60;
+    int hourlyCost = 10;
+    Arrivals arrivals = Arrivals::Uniform;
+    double errorRate = 0.02;     // share of events that the club rejects with event 13
+    double queuePressure = 0.5;  // chance that a client waits when every table is busy
+    uint64_t seed = 1;
+    std::string output;          // stdout if empty
+};
+
+// xorshift64*: the same sequence on every platform for a given seed
+class Random {
+public:
+    explicit Random(uint64_t seed) : m_state(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+    uint64_t next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+    // Uniform in [0, bound)
+    size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+    // Uniform in [0, 1)
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+private:
+    uint64_t m_state;
+};
+
+// Set of small integers with O(1) insert, erase and random pick
+class IndexSet {
+public:
+    explicit IndexSet(int capacity) : m_position(capacity, -1) {}
+    bool empty() const { return m_items.empty(); }
+    bool contains(int item) const { return m_position[item] >= 0; }
+    void insert(int item) {
+        if (contains(item))
+            return;
+        m_position[item] = static_cast<int>(m_items.size());
+        m_items.push_back(item);
+    }
+    void erase(int item) {
+        if (!contains(item))
+            return;
+        int last = m_items.back();
+        m_items[m_position[item]] = last;
+        m_position[last] = m_position[item];
+        m_items.pop_back();
+        m_position[item] = -1;
+    }
+    int pick(Random &random) const { return m_items[random.below(m_items.size())]; }
+private:
+    std::vector<int> m_items;
+    std::vector<int> m_position;
+};
+
+// Mirror of the club rules, so that generated events mean what they are meant to:
+// valid events change the state, error events leave it as is.
+class Generator {
+public:
+    Generator(const Options &options, FdSink &out)
+        : m_options(options), m_out(out), m_random(options.seed),
+          m_outside(options.clients), m_inside(options.clients), m_seated(options.clients),
+          m_waiting(options.clients), m_freeTables(options.tables), m_clientTable(options.clients, 0),
+          m_tableClient(options.tables + 1, -1) {
+        for (int client = 0; client < options.clients; client++)
+            m_outside.insert(client);
+        for (int table = 1; table <= options.tables; table++)
+            m_freeTables.insert(table - 1);
+    }
+
+    void run() {
+        m_out.appendInt(m_options.tables).endLine();
+        m_out.appendTime(m_options.openTime).appendChar(' ').appendTime(m_options.closeTime).endLine();
+        m_out.appendInt(m_options.hourlyCost).endLine();
+        double poissonTime = m_options.openTime;
+        for (long long i = 0; i < m_options.events; i++) {
+            int time = eventTime(i, poissonTime);
+            if (time != m_time || i == 0) {
+                m_time = time;
+                m_timeLength = Yadro::Time::Format(time, m_timeText);
+            }
+            if (m_random.unit() < m_options.errorRate && errorEvent())
+                continue;
+            validEvent();
+        }
+    }
+private:
+    const Options &m_options;
+    FdSink &m_out;
+    Random m_random;
+    IndexSet m_outside;      // not in the club
+    IndexSet m_inside;       // in the club, neither seated nor waiting
+    IndexSet m_seated;
+    IndexSet m_waiting;
+    IndexSet m_freeTables;   // table number - 1
+    std::vector<int> m_clientTable;
+    std::vector<int> m_tableClient;
+    Yadro::WaitingQueue m_queue;
+    int m_time = 0;
+    // Events share a minute most of the time, so its text is formatted once.
+    char m_timeText[Yadro::Time::kMaxLength];
+    size_t m_timeLength = 0;
+
+    // Times never decrease; the shape of the distribution decides where events crowd.
+    int eventTime(long long index, double &poissonTime) {
+        double span = m_options.closeTime - m_options.openTime;
+        double position = (index + 0.5) / static_cast<double>(m_options.events);
+        double time;
+        switch (m_options.arrivals) {
+        case Arrivals::Peak: {
+            // Triangular density with the peak at 70% of the working hours
+            const double mode = 0.7;
+            double fraction = position < mode ? std::sqrt(position * mode) : 1 - std::sqrt((1 - position) * (1 - mode));
+            time = m_options.openTime + fraction * span;
+            break;
+        }
+        case Arrivals::Poisson:
+            poissonTime += -std::log(1 - m_random.unit()) * span / static_cast<double>(m_options.events);
+            time = poissonTime;
+            break;
+        default:
+            time = m_options.openTime + position * span;
+            break;
+        }
+        return std::min(static_cast<int>(time), m_options.closeTime);
+    }
+
+    void line(int eventId, int client, int table = 0) {
+        m_out.append(std::string_view(m_timeText, m_timeLength)).appendChar(' ').appendChar(static_cast<char>('0' + eventId));
+        m_out.append(" client").appendInt(client);
+        if (eventId == 2)
+            m_out.appendChar(' ').appendInt(table);
+        m_out.endLine();
+    }
+
+    void validEvent() {
+        double choice = m_random.unit();
+        if (choice < 0.35 && !m_outside.empty()) {
+            arrive(m_outside.pick(m_random));
+        } else if (choice < 0.65 && !m_inside.empty()) {
+            int client = m_inside.pick(m_random);
+            if (!m_freeTables.empty())
+                sit(client, m_freeTables.pick(m_random) + 1);
+            else if (m_random.unit() < m_options.queuePressure)
+                wait(client);
+            else
+                leave(client);
+        } else if (choice < 0.7 && !m_seated.empty() && !m_freeTables.empty()) {
+            sit(m_seated.pick(m_random), m_freeTables.pick(m_random) + 1);
+        } else if (!m_seated.empty() || !m_inside.empty() || !m_waiting.empty()) {
+            leave(pickInClub());
+        } else {
+            arrive(m_outside.pick(m_random));
+        }
+    }
+
+    // Any client in the club: seated, waiting or neither
+    int pickInClub() {
+        while (true) {
+            size_t kind = m_random.below(3);
+            if (kind == 0 && !m_seated.empty())
+                return m_seated.pick(m_random);
+            if (kind == 1 && !m_inside.empty())
+                return m_inside.pick(m_random);
+            if (kind == 2 && !m_waiting.empty())
+                return m_waiting.pick(m_random);
+        }
+    }
+
+    // An event the club answers with event 13; false if none fits the current state.
+    bool errorEvent() {
+        switch (m_random.below(4)) {
+        case 0: // YouShallNotPass
+            if (m_seated.empty())
+                return false;
+            line(1, m_seated.pick(m_random));
+            return true;
+        case 1: // ClientUnknown
+            if (m_outside.empty())
+                return false;
+            if (m_random.below(2) == 0)
+                line(4, m_outside.pick(m_random));
+            else
+                line(2, m_outside.pick(m_random), static_cast<int>(m_random.below(m_options.tables)) + 1);
+            return true;
+        case 2: { // PlaceIsBusy
+            if (m_inside.empty() || m_seated.empty())
+                return false;
+            line(2, m_inside.pick(m_random), m_clientTable[m_seated.pick(m_random)]);
+            return true;
+        }
+        default: // ICanWaitNoLonger!
+            if (m_inside.empty() || m_freeTables.empty())
+                return false;
+            line(3, m_inside.pick(m_random));
+            return true;
+        }
+    }
+
+    void arrive(int client) {
+        line(1, client);
+        m_outside.erase(client);
+        m_inside.insert(client);
+    }
+
+    void sit(int client, int table) {
+        line(2, client, table);
+        if (m_clientTable[client] != 0)
+            freeTable(m_clientTable[client]);
+        m_inside.erase(client);
+        takeTable(client, table);
+    }
+
+    void wait(int client) {
+        line(3, client);
+        m_inside.erase(client);
+        m_waiting.insert(client);
+        m_queue.push(client);
+        if (static_cast<int>(m_queue.size()) > m_options.tables) {
+            // The queue is full: the client leaves at once (event 11).
+            removeWaiting(client);
+            m_outside.insert(client);
+        }
+    }
+
+    void leave(int client) {
+        line(4, client);
+        if (m_clientTable[client] != 0)
+            freeTable(m_clientTable[client]);
+        else if (m_waiting.contains(client))
+            removeWaiting(client);
+        m_inside.erase(client);
+        m_seated.erase(client);
+        m_outside.insert(client);
+    }
+
+    void takeTable(int client, int table) {
+        m_clientTable[client] = table;
+        m_tableClient[table] = client;
+        m_seated.insert(client);
+        m_freeTables.erase(table - 1);
+    }
+
+    void freeTable(int table) {
+        int client = m_tableClient[table];
+        m_clientTable[client] = 0;
+        m_tableClient[table] = -1;
+        m_seated.erase(client);
+        m_freeTables.insert(table - 1);
+        // The club seats the first waiting client at once, unless it is closing time.
+        if (m_time != m_options.closeTime && !m_queue.empty()) {
+            int next = m_queue.pop();
+            m_waiting.erase(next);
+            takeTable(next, table);
+        }
+    }
+
+    void removeWaiting(int client) {
+        m_queue.remove(client);
+        m_waiting.erase(client);
+    }
+};
+
+void printUsage(const char *program) {
+    std::cerr << "Usage: " << program << " [--events N] [--clients N] [--tables N] [--open HH:MM] [--close HH:MM]\n"
+              << "       [--cost N] [--arrivals uniform|peak|poisson] [--error-rate F] [--queue-pressure F]\n"
+              << "       [--seed N] [--output FILE]" << std::endl;
+}
+
+bool parseRate(const std::string &text, double &rate) {
+    char *end = nullptr;
+    rate = std::strtod(text.c_str(), &end);
+    return *end == '\0' && rate >= 0 && rate <= 1;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        if (arg == "--events") {
+            char *end = nullptr;
+            options.events = std::strtoll(value.c_str(), &end, 10);
+            if (*end != '\0' || options.events < 0)
+                return false;
+        } else if (arg == "--clients" || arg == "--tables" || arg == "--cost" || arg == "--seed") {
+            auto maybeNum = Yadro::Util::FromString(value);
+            if (!maybeNum.has_value() || maybeNum.value() <= 0)
+                return false;
+            if (arg == "--clients")
+                options.clients = maybeNum.value();
+            else if (arg == "--tables")
+                options.tables = maybeNum.value();
+            else if (arg == "--cost")
+                options.hourlyCost = maybeNum.value();
+            else
+                options.seed = maybeNum.value();
+        } else if (arg == "--open" || arg == "--close") {
+            auto maybeTime = Yadro::Time::FromString(value);
+            if (!maybeTime.has_value())
+                return false;
+            (arg == "--open" ? options.openTime : options.closeTime) = maybeTime.value();
+        } else if (arg == "--arrivals") {
+            if (value == "uniform")
+                options.arrivals = Arrivals::Uniform;
+            else if (value == "peak")
+                options.arrivals = Arrivals::Peak;
+            else if (value == "poisson")
+                options.arrivals = Arrivals::Poisson;
+            else
+                return false;
+        } else if (arg == "--error-rate") {
+            if (!parseRate(value, options.errorRate))
+                return false;
+        } else if (arg == "--queue-pressure") {
+            if (!parseRate(value, options.queuePressure))
+                return false;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return options.openTime < options.closeTime;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    int fd = STDOUT_FILENO;
+    if (!options.output.empty()) {
+        fd = ::open(options.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "Error: Cannot create file " << options.output << std::endl;
+            return 1;
+        }
+    }
+    bool written;
+    {
+        FdSink out(fd);
+        Generator generator(options, out);
+        generator.run();
+        out.flush();
+        written = out.good();
+    }
+    if (fd != STDOUT_FILENO && ::close(fd) != 0)
+        written = false;
+    return written ? 0 : 1;
+}
@@ -0,0 +1,613 @@
+#include <gtest/gtest.h>
+#include "../../project/Batch.hpp"
+#include "../../project/Sharded.hpp"
+#include "../../project/ThreadPool.hpp"
+#include "../../project/Runner.hpp"
+#include "../../project/OutputSink.hpp"
+#include "../../project/DayArena.hpp"
+#include "../../project/Sweep.hpp"
+#include "../../project/Server.hpp"
+#include "../../project/Pipeline.hpp"
+#include "../../project/SpscRing.hpp"
+#include "../../project/Time.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Yadro::BatchOptions;
+using Yadro::ThreadPool;
+
+// Helper function to write content to a file.
+bool writeToFile(const std::string &filename, const std::string &content) {
+    std::ofstream ofs(filename);
+    if (!ofs)
+        return false;
+    ofs << content;
+    return true;
+}
+
+std::string readFile(const std::string &filename) {
+    std::ifstream ifs(filename);
+    std::ostringstream content;
+    content << ifs.rdbuf();
+    return content.str();
+}
+
+// *************************
+// Tests for the thread pool
+// *************************
+
+TEST(ThreadPoolTest, RunsEveryTask) {
+    std::atomic<int> sum{0};
+    ThreadPool pool(4);
+    for (int i = 1; i <= 1000; i++)
+        pool.submit([&sum, i] { sum += i; });
+    pool.wait();
+    EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(ThreadPoolTest, TasksCanSubmitTasks) {
+    std::atomic<int> count{0};
+    ThreadPool pool(3);
+    for (int i = 0; i < 10; i++) {
+        pool.submit([&pool, &count] {
+            for (int j = 0; j < 10; j++)
+                pool.submit([&count] { count++; });
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(count.load(), 100);
+}
+
+// *************************
+// Tests for the batch mode
+// *************************
+
+TEST(BatchTest, OutputPath) {
+    EXPECT_EQ(Yadro::batchOutputPath("inputs/test1.in.txt", "out"), "out/test1.out.txt");
+    EXPECT_EQ(Yadro::batchOutputPath("club.log", "out"), "out/club.log.out");
+}
+
+TEST(BatchTest, EachFileGetsItsOwnOutput) {
+    std::vector<std::string> inputs = {"batch_a.in.txt", "batch_b.in.txt", "batch_c.in.txt"};
+    ASSERT_TRUE(writeToFile(inputs[0], "1\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 1\n"));
+    ASSERT_TRUE(writeToFile(inputs[1], "2\n10:00 20:00\n5\n09:10 1 b\n"));
+    ASSERT_TRUE(writeToFile(inputs[2], "x\n10:00 20:00\n5\n"));
+
+    BatchOptions options;
+    options.inputs = inputs;
+    options.jobs = 2;
+    std::vector<std::string> errors;
+    EXPECT_EQ(Yadro::runBatch(options, errors), 0);
+    EXPECT_TRUE(errors.empty());
+
+    for (const auto &input : inputs) {
+        Yadro::MemorySink expected;
+        Yadro::runClubFile(input, expected);
+        std::string output = Yadro::batchOutputPath(input, ".");
+        EXPECT_EQ(readFile(output), expected.data());
+        std::remove(input.c_str());
+        std::remove(output.c_str());
+    }
+}
+
+TEST(BatchTest, ManifestListsFiles) {
+    ASSERT_TRUE(writeToFile("batch_manifest.txt", "one.in.txt\r\n\ntwo.in.txt\n"));
+    std::vector<std::string> files;
+    std::string error;
+    EXPECT_TRUE(Yadro::collectBatchInputs({"@batch_manifest.txt", "three.in.txt"}, files, error));
+    std::vector<std::string> expected = {"one.in.txt", "two.in.txt", "three.in.txt"};
+    EXPECT_EQ(files, expected);
+    std::remove("batch_manifest.txt");
+}
+
+// *************************
+// Tests for the sharded multi-club engine
+// *************************
+
+TEST(ShardedTest, InterleavedClubsMatchSeparateRuns) {
+    std::string clubA = "2\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n09:31 3 b\n10:00 4 a\n";
+    std::string clubB = "1\n10:00 20:00\n5\n09:10 1 b\n10:10 1 c\n10:11 2 c 1\n";
+    ASSERT_TRUE(writeToFile("club_a.in.txt", clubA));
+    ASSERT_TRUE(writeToFile("club_b.in.txt", clubB));
+    // Interleave the two inputs line by line, plus a club with a bad line.
+    std::istringstream a(clubA), b(clubB);
+    std::string combined, line;
+    while (true) {
+        bool more = false;
+        if (std::getline(a, line)) { combined += "club_a " + line + "\n"; more = true; }
+        if (std::getline(b, line)) { combined += "club_b " + line + "\n"; more = true; }
+        if (!more)
+            break;
+    }
+    combined += "club_c 1\nclub_c 09:00 19:00\nclub_c 0\n";
+    ASSERT_TRUE(writeToFile("combined.txt", combined));
+
+    Yadro::ShardedOptions options;
+    options.input = "combined.txt";
+    options.jobs = 2;
+    std::vector<Yadro::ClubSummary> summary;
+    std::vector<std::string> errors;
+    EXPECT_TRUE(Yadro::runSharded(options, summary, errors));
+    EXPECT_TRUE(errors.empty());
+
+    ASSERT_EQ(summary.size(), 3);
+    EXPECT_EQ(summary[0].clubId, "club_a");
+    EXPECT_TRUE(summary[0].accepted);
+    EXPECT_EQ(summary[0].revenue, 10);
+    EXPECT_EQ(summary[2].clubId, "club_c");
+    EXPECT_FALSE(summary[2].accepted);
+    EXPECT_EQ(readFile("club_c.out.txt"), "0\n");
+
+    for (const std::string club : {"club_a", "club_b"}) {
+        Yadro::MemorySink expected;
+        Yadro::runClubFile(club + ".in.txt", expected);
+        EXPECT_EQ(readFile(club + ".out.txt"), expected.data());
+        std::remove((club + ".in.txt").c_str());
+        std::remove((club + ".out.txt").c_str());
+    }
+    std::remove("club_c.out.txt");
+    std::remove("combined.txt");
+}
+
+// *************************
+// Tests for the online mode
+// *************************
+
+// Run the online mode over content sent through a pipe.
+static std::string runOnlineOver(const std::string &content, bool &accepted,
+                                 const Yadro::OnlineOptions &options = Yadro::OnlineOptions()) {
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+    EXPECT_EQ(write(fds[1], content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fds[1]);
+    Yadro::MemorySink out;
+    std::vector<std::string> errors;
+    accepted = Yadro::runOnline(fds[0], out, options, errors);
+    EXPECT_TRUE(errors.empty());
+    close(fds[0]);
+    return std::string(out.data());
+}
+
+TEST(OnlineTest, SameOutputAsFileMode) {
+    std::string content = "2\r\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n09:31 3 b\n\n10:00 4 a\n10:05 1 c";
+    ASSERT_TRUE(writeToFile("online.in.txt", content));
+    Yadro::MemorySink expected;
+    EXPECT_TRUE(Yadro::runClubFile("online.in.txt", expected));
+    std::remove("online.in.txt");
+
+    bool accepted = false;
+    EXPECT_EQ(runOnlineOver(content, accepted), expected.data());
+    EXPECT_TRUE(accepted);
+}
+
+TEST(OnlineTest, DayEndsAfterCloseTime) {
+    bool accepted = false;
+    std::string output = runOnlineOver("1\n09:00 19:00\n10\n09:10 1 a\n18:00 2 a 1\n19:30 4 a\n20:00 1 b\n", accepted);
+    EXPECT_TRUE(accepted);
+    EXPECT_EQ(output, "09:00\n09:10 1 a\n18:00 2 a 1\n19:00 11 a\n19:00\n1 10 01:00\n");
+}
+
+TEST(OnlineTest, BadLineStopsAfterEarlierOutput) {
+    bool accepted = true;
+    std::string output = runOnlineOver("1\n09:00 19:00\n10\n09:10 1 a\n09:20 7 a\n09:30 1 b\n", accepted);
+    EXPECT_FALSE(accepted);
+    EXPECT_EQ(output, "09:00\n09:10 1 a\n09:20 7 a\n");
+
+    output = runOnlineOver("1\n09:00 19:00", accepted);
+    EXPECT_FALSE(accepted);
+    EXPECT_EQ(output.substr(0, 40), "Not enough configuration lines provided.");
+}
+
+TEST(OnlineTest, ResumeFromCheckpoint) {
+    std::string head = "2\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n\n09:31 2 b 2\n";
+    std::string tail = "09:40 1 c\n09:41 3 c\n10:00 4 a\n";
+    bool accepted = false;
+    std::string full = runOnlineOver(head + tail, accepted);
+
+    // A run that stops after the head leaves a checkpoint of its 4 events.
+    Yadro::OnlineOptions options;
+    options.checkpointPath = "online.checkpoint";
+    options.checkpointEvery = 2;
+    std::string printed = "09:00\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n09:31 2 b 2\n";
+    std::string first = runOnlineOver(head, accepted, options);
+    EXPECT_EQ(first.substr(0, printed.size()), printed);
+    EXPECT_EQ(full.substr(0, printed.size()), printed);
+
+    // The restarted run skips what the checkpoint has and prints the rest of the day.
+    Yadro::OnlineOptions resume;
+    resume.resumePath = options.checkpointPath;
+    std::string rest = runOnlineOver(head + tail, accepted, resume);
+    EXPECT_TRUE(accepted);
+    EXPECT_EQ(full.substr(printed.size()), rest);
+    std::remove("online.checkpoint");
+}
+
+// *************************
+// Tests for the run statistics
+// *************************
+
+TEST(StatsTest, RunIsTimedAndDumpedAsJson) {
+    ASSERT_TRUE(writeToFile("stats.in.txt", "1\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n09:31 3 b\n"));
+    Yadro::RunStats stats;
+    Yadro::MemorySink out, plain;
+    EXPECT_TRUE(Yadro::runClubFile("stats.in.txt", out, 1, &stats));
+    Yadro::runClubFile("stats.in.txt", plain);
+    std::remove("stats.in.txt");
+    EXPECT_EQ(out.data(), plain.data());
+
+    uint64_t latencyCount = 0;
+    for (uint64_t count : stats.latency)
+        latencyCount += count;
+    EXPECT_EQ(latencyCount, 4);
+    EXPECT_GT(stats.phaseNanos[Yadro::RunStats::Parse], 0);
+
+    Yadro::MemorySink json;
+    stats.writeJson(json);
+    std::string text(json.data());
+    EXPECT_EQ(text.front(), '{');
+    EXPECT_NE(text.find("\"events\": {\"1\": 2, \"2\": 1, \"3\": 1, \"4\": 0}"), std::string::npos);
+    EXPECT_NE(text.find("\"peakQueue\": 1"), std::string::npos);
+    EXPECT_NE(text.find("\"phaseNanos\": {\"read\": "), std::string::npos);
+}
+
+// *************************
+// Tests for the day arena
+// *************************
+
+TEST(DayArenaTest, DaysInTheArenaMatchTheHeap) {
+    std::string content = "2\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 1\n09:30 1  b\n09:31 3 b\n10:00 4 a\n10:05 1 c\n";
+    ASSERT_TRUE(writeToFile("arena.in.txt", content));
+    Yadro::MemorySink expected;
+    EXPECT_TRUE(Yadro::runClubFile("arena.in.txt", expected));
+
+    // A tiny first block makes the first day overflow, so the block must grow.
+    Yadro::DayArena arena(64);
+    for (int day = 0; day < 3; day++) {
+        Yadro::MemorySink out;
+        EXPECT_TRUE(Yadro::runClubFile("arena.in.txt", out, 1, nullptr, arena.resource()));
+        EXPECT_EQ(out.data(), expected.data());
+        arena.reset();
+    }
+    std::remove("arena.in.txt");
+    EXPECT_GT(arena.capacity(), 64u);
+}
+
+TEST(DayArenaTest, BlockIsReusedAndCapped) {
+    Yadro::DayArena arena(1024, 4096);
+    void *first = arena.resource()->allocate(512);
+    arena.reset();
+    EXPECT_EQ(arena.resource()->allocate(512), first);
+    EXPECT_EQ(arena.capacity(), 1024u);
+
+    EXPECT_NE(arena.resource()->allocate(100000), nullptr);
+    arena.reset();
+    EXPECT_EQ(arena.capacity(), 4096u);
+}
+
+TEST(BatchTest, OutputModesAreFilteredFullOutput) {
+    ASSERT_TRUE(writeToFile("modes.in.txt", "2\n09:00 19:00\n10\n08:00 1 a\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n"
+                                            "09:31 3 b\n09:32 2 b 1\n10:00 4 a\n"));
+    Yadro::MemorySink full, report, errors, summary;
+    EXPECT_TRUE(Yadro::runClubFile("modes.in.txt", full));
+    auto run = [](Yadro::OutputMode mode, Yadro::MemorySink &out) {
+        return Yadro::runClubFile("modes.in.txt", out, 1, nullptr, std::pmr::get_default_resource(), mode);
+    };
+    EXPECT_TRUE(run(Yadro::OutputMode::ReportOnly, report));
+    EXPECT_TRUE(run(Yadro::OutputMode::ErrorsOnly, errors));
+    EXPECT_TRUE(run(Yadro::OutputMode::Summary, summary));
+
+    std::vector<std::string> lines = full.lines();
+    std::string expectedErrors;
+    for (const auto &line : lines) {
+        if (line.find(" 13 ") != std::string::npos)
+            expectedErrors += line + "\n";
+    }
+    EXPECT_EQ(errors.data(), expectedErrors);
+    EXPECT_EQ(report.lines(), std::vector<std::string>(lines.end() - 2, lines.end()));
+    EXPECT_EQ(summary.data(), "total 10 00:40\n");
+
+    // A bad line is printed in every mode.
+    ASSERT_TRUE(writeToFile("modes.in.txt", "2\n09:00 19:00\n10\n09:10 1 a\n09:20 7 a\n"));
+    Yadro::MemorySink bad;
+    EXPECT_FALSE(run(Yadro::OutputMode::Summary, bad));
+    EXPECT_EQ(bad.data(), "09:20 7 a\n");
+    std::remove("modes.in.txt");
+}
+
+// *************************
+// Tests for the parameter sweep
+// *************************
+
+TEST(SweepTest, ExpandVariants) {
+    Yadro::ClubConfig base{9 * 60, 19 * 60, 3, 10};
+    std::vector<Yadro::ClubConfig> variants;
+    EXPECT_TRUE(Yadro::expandVariants("", base, variants));
+    EXPECT_TRUE(variants.empty());
+    EXPECT_TRUE(Yadro::expandVariants("* * * *", base, variants));
+    EXPECT_TRUE(Yadro::expandVariants("1..5/2 08:00,09:30 * 20", base, variants));
+    ASSERT_EQ(variants.size(), 7u);
+    EXPECT_EQ(variants[0].numTables, 3);
+    EXPECT_EQ(variants[2].numTables, 1);
+    EXPECT_EQ(variants[2].openTime, 9 * 60 + 30);
+    EXPECT_EQ(variants[6].numTables, 5);
+    EXPECT_EQ(variants[6].closeTime, 19 * 60);
+    EXPECT_EQ(variants[6].hourlyCost, 20);
+
+    EXPECT_FALSE(Yadro::expandVariants("3 09:00 19:00", base, variants));
+    EXPECT_FALSE(Yadro::expandVariants("0 * * *", base, variants));
+    EXPECT_FALSE(Yadro::expandVariants("* 20:00 19:00 *", base, variants));
+    EXPECT_FALSE(Yadro::expandVariants("5..1 * * *", base, variants));
+    EXPECT_FALSE(Yadro::expandVariants("1..5/0 * * *", base, variants));
+    EXPECT_FALSE(Yadro::expandVariants("* 09:00..10:00 * *", base, variants));
+}
+
+TEST(SweepTest, VariantsMatchRunsWithEditedConfig) {
+    std::string events = "08:50 1 a\n09:10 1 a\n09:20 2 a 1\n09:30 1 b\n09:31 2 b 2\n09:40 1 c\n09:41 3 c\n"
+                         "09:50 1 d\n09:51 3 d\n11:00 4 a\n20:30 4 b\n";
+    ASSERT_TRUE(writeToFile("sweep.in.txt", "2\n09:00 19:00\n10\n" + events));
+    Yadro::ParsedDay day;
+    std::string errorLine;
+    ASSERT_TRUE(day.load("sweep.in.txt", errorLine));
+    EXPECT_EQ(day.size(), 11u);
+
+    std::vector<Yadro::ClubConfig> variants;
+    ASSERT_TRUE(Yadro::expandVariants("1..3 08:00,09:00 19:00,21:00 10,15", day.config(), variants));
+    std::vector<Yadro::SweepResult> results = Yadro::runSweep(day, variants, 2);
+    ASSERT_EQ(results.size(), 24u);
+    for (const auto &result : results) {
+        const Yadro::ClubConfig &config = result.config;
+        ASSERT_TRUE(writeToFile("sweep.in.txt", std::to_string(config.numTables) + "\n" + Yadro::Time::ToString(config.openTime)
+                                + " " + Yadro::Time::ToString(config.closeTime) + "\n"
+                                + std::to_string(config.hourlyCost) + "\n" + events));
+        Yadro::MemorySink full;
+        bool accepted = Yadro::runClubFile("sweep.in.txt", full);
+        EXPECT_EQ(result.accepted, accepted);
+        if (!accepted)
+            continue;
+        Yadro::MemorySink summary;
+        Yadro::runClubFile("sweep.in.txt", summary, 1, nullptr, std::pmr::get_default_resource(), Yadro::OutputMode::Summary);
+        uint64_t sentAway = 0;
+        for (const auto &line : full.lines())
+            sentAway += line.find(" 11 ") != std::string::npos;
+        EXPECT_EQ(std::string(summary.data()), "total " + std::to_string(result.revenue) + " "
+                  + Yadro::Time::ToString(static_cast<int>(result.occupied)) + "\n");
+        EXPECT_EQ(result.sentAway, sentAway);
+    }
+    std::remove("sweep.in.txt");
+
+    Yadro::MemorySink out;
+    Yadro::writeSweep({results[0], results.back()}, out);
+    EXPECT_EQ(out.lines()[0], "1 08:00 19:00 10 rejected");
+    // a and b pay 2 and 11 hours, c and d are sent away at the close, 759 of 2160 minutes taken.
+    EXPECT_EQ(out.lines()[1], "3 09:00 21:00 15 195 2 35.1%");
+}
+
+TEST(SweepTest, MinTablesMatchesLinearScan) {
+    // a takes the only table the events name and the others ask to wait.
+    std::string events = "09:00 1 a\n09:00 1 b\n09:00 1 c\n09:00 1 d\n09:00 1 e\n09:01 2 a 1\n"
+                         "09:02 3 b\n09:02 3 c\n09:02 3 d\n09:02 3 e\n10:00 4 a\n";
+    ASSERT_TRUE(writeToFile("mintables.in.txt", "1\n09:00 19:00\n10\n" + events));
+    Yadro::ParsedDay day;
+    std::string errorLine;
+    ASSERT_TRUE(day.load("mintables.in.txt", errorLine));
+    std::remove("mintables.in.txt");
+    EXPECT_EQ(day.minTables(), 1);
+    EXPECT_EQ(day.maxUsefulTables(), 2);
+
+    std::vector<uint64_t> overflows;
+    for (int tables = day.minTables(); tables <= 5; tables++)
+        overflows.push_back(day.queueOverflows(tables, UINT64_MAX));
+    // One table takes one waiting client; with a free table nobody can wait at all.
+    EXPECT_EQ(overflows, (std::vector<uint64_t>{3, 0, 0, 0, 0}));
+    // The run stops at the first overflow over the budget.
+    EXPECT_EQ(day.queueOverflows(1, 0), 1u);
+
+    for (uint64_t budget = 0; budget <= 3; budget++) {
+        Yadro::CapacityResult result = Yadro::solveMinTables(day, budget);
+        int expected = day.minTables();
+        while (overflows[expected - day.minTables()] > budget)
+            expected++;
+        EXPECT_EQ(result.tablesCount, expected) << budget;
+        EXPECT_EQ(result.overflows, overflows[expected - day.minTables()]) << budget;
+        EXPECT_EQ(result.simulations, 1) << budget;
+    }
+}
+
+// *************************
+// Tests for the club server
+// *************************
+
+// Body lines of the answers in out, without the "ok <n>" lines
+std::string answerBodies(std::string_view out) {
+    std::string bodies;
+    Yadro::MemorySink sink;
+    sink.append(out);
+    std::vector<std::string> lines = sink.lines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        size_t count = std::stoul(lines[i].substr(3));
+        for (size_t j = 0; j < count; j++)
+            bodies += lines[++i] + "\n";
+    }
+    return bodies;
+}
+
+TEST(ServerTest, AnswersAddUpToFileOutput) {
+    Yadro::ClubServer server(1);
+    Yadro::MemorySink out;
+    std::ifstream input("../../tests/inputs/test1.in.txt");
+    std::string config[3];
+    for (auto &line : config)
+        std::getline(input, line);
+    server.handle("open one " + config[0] + " " + config[1] + " " + config[2], out);
+    for (std::string line; std::getline(input, line);)
+        server.handle("event one " + line, out);
+    server.handle("close one", out);
+    EXPECT_EQ(answerBodies(out.data()), readFile("../../tests/outputs/test1.out.txt"));
+}
+
+TEST(ServerTest, QueriesAndErrors) {
+    Yadro::ClubServer server(1);
+    Yadro::MemorySink out;
+    for (const char *request : {"open a 2 09:00 19:00 10", "open b 1 10:00 20:00 5", "event a 09:00 1 x",
+                                "event a 09:00 2 x 1", "event a 09:10 1 y", "event a 09:11 2 y 2",
+                                "event a 09:12 1 z", "event a 09:13 3 z", "occupancy a", "queue a", "event a 10:05 4 x",
+                                "revenue a", "occupancy a", "queue a", "clubs"})
+        server.handle(request, out);
+    EXPECT_EQ(out.lines(), (std::vector<std::string>{
+        "ok 1", "09:00", "ok 1", "10:00", "ok 1", "09:00 1 x", "ok 1", "09:00 2 x 1", "ok 1", "09:10 1 y",
+        "ok 1", "09:11 2 y 2", "ok 1", "09:12 1 z", "ok 1", "09:13 3 z", "ok 1", "2 2", "ok 1", "1",
+        // z takes the table x left.
+        "ok 2", "10:05 4 x", "10:05 12 z 1", "ok 1", "20", "ok 1", "2 2", "ok 1", "0", "ok 2", "a", "b"}));
+
+    out.clear();
+    for (const char *request : {"open a 2 09:00 19:00 10", "open c 0 09:00 19:00 10", "event a 9:00 1 x",
+                                "event a 09:00 2 x 3", "event nope 09:00 1 x", "queue a extra", "dance a", "close",
+                                "", "close b", "queue b"})
+        server.handle(request, out);
+    EXPECT_EQ(out.lines(), (std::vector<std::string>{
+        "error club exists", "error bad config", "error bad event", "error bad event", "error unknown club",
+        "error bad request", "error bad request", "error bad request", "ok 2", "20:00", "1 0 00:00",
+        "error unknown club"}));
+}
+
+TEST(ServerTest, PipelinedRequestsOverSocket) {
+    std::string path = "server_test." + std::to_string(::getpid()) + ".sock";
+    Yadro::ClubServer server(2);
+    std::string errorLine;
+    ASSERT_TRUE(server.listen(path, errorLine)) << errorLine;
+    std::thread serving([&server] { server.run(); });
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+    // Sent in one go and split in the middle of a line; the answers come in request order.
+    std::string requests = "open a 1 09:00 19:00 10\nevent a 09:00 1 x\nevent a 09:00 2 x 1\nocc";
+    ASSERT_EQ(::write(fd, requests.data(), requests.size()), static_cast<ssize_t>(requests.size()));
+    ASSERT_EQ(::write(fd, "upancy a\nclose a\n", 17), 17);
+    std::string expected = "ok 1\n09:00\nok 1\n09:00 1 x\nok 1\n09:00 2 x 1\nok 1\n1 1\nok 3\n19:00 11 x\n19:00\n1 100 10:00\n";
+    std::string answers;
+    char chunk[256];
+    while (answers.size() < expected.size()) {
+        ssize_t count = ::read(fd, chunk, sizeof(chunk));
+        if (count <= 0)
+            break;
+        answers.append(chunk, count);
+    }
+    EXPECT_EQ(answers, expected);
+    ::close(fd);
+
+    server.stop();
+    serving.join();
+}
+
+int connectTo(const std::string &path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+TEST(ServerTest, ClientThatDoesNotReadStallsOnlyItself) {
+    std::string path = "server_test_stall." + std::to_string(::getpid()) + ".sock";
+    Yadro::ClubServer server(1);
+    std::string errorLine;
+    ASSERT_TRUE(server.listen(path, errorLine)) << errorLine;
+    std::thread serving([&server] { server.run(); });
+
+    // Requests until the socket buffers both ways are full, and no answer is read.
+    int stalled = connectTo(path);
+    ASSERT_GE(stalled, 0);
+    ::fcntl(stalled, F_SETFL, O_NONBLOCK);
+    std::string requests;
+    for (int i = 0; i < 4096; i++)
+        requests += "queue x\n";
+    for (int idle = 0; idle < 20;) {
+        if (::write(stalled, requests.data(), requests.size()) > 0) {
+            idle = 0;
+        } else {
+            idle++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    // The only worker must still answer another client.
+    int other = connectTo(path);
+    ASSERT_GE(other, 0);
+    timeval timeout{3, 0};
+    ::setsockopt(other, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ASSERT_EQ(::write(other, "clubs\n", 6), 6);
+    char answer[16];
+    ssize_t count = ::read(other, answer, sizeof(answer));
+    EXPECT_EQ(std::string(answer, count > 0 ? count : 0), "ok 0\n");
+    ::close(other);
+    ::close(stalled);
+
+    server.stop();
+    serving.join();
+}
+
+// *************************
+// Tests for the pipelined mode
+// *************************
+
+TEST(SpscRingTest, ItemsArriveInOrder) {
+    // A small ring wraps around many times.
+    auto ring = std::make_unique<Yadro::SpscRing<uint64_t, 8>>();
+    const uint64_t count = 200000;
+    std::thread producer([&ring, count] {
+        for (uint64_t i = 0; i < count; i++)
+            ring->push(i);
+    });
+    uint64_t expected = 0;
+    for (; expected < count; expected++) {
+        if (ring->pop() != expected)
+            break;
+    }
+    producer.join();
+    EXPECT_EQ(expected, count);
+    uint64_t item;
+    EXPECT_FALSE(ring->tryPop(item));
+}
+
+TEST(PipelineTest, SameOutputAsFileMode) {
+    std::vector<std::string> inputs;
+    for (int i = 1; i <= 5; i++)
+        inputs.push_back("../../tests/inputs/test" + std::to_string(i) + ".in.txt");
+    // More lines than a ring holds, with a bad line late in the file.
+    std::string day = "3\n09:00 19:00\n10\n";
+    for (int i = 0; i < 20000; i++)
+        day += "10:00 1 c" + std::to_string(i) + "\n" + (i == 15000 ? "10:00 5 c1\n" : "");
+    ASSERT_TRUE(writeToFile("pipeline.bad.txt", day));
+    inputs.push_back("pipeline.bad.txt");
+    inputs.push_back("pipeline.missing.txt");
+
+    for (const auto &input : inputs) {
+        for (Yadro::OutputMode mode : {Yadro::OutputMode::Full, Yadro::OutputMode::ReportOnly,
+                                       Yadro::OutputMode::ErrorsOnly, Yadro::OutputMode::Summary}) {
+            Yadro::MemorySink expected;
+            Yadro::MemorySink piped;
+            bool accepted = Yadro::runClubFile(input, expected, 1, nullptr, std::pmr::get_default_resource(), mode);
+            EXPECT_EQ(Yadro::runPipelined(input, piped, mode), accepted) << input;
+            EXPECT_EQ(piped.data(), expected.data()) << input;
+        }
+    }
+    std::remove("pipeline.bad.txt");
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "../../project/Club.hpp"
 #include "../../project/Time.hpp"
+#include "../../project/Utilization.hpp"
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -274,3 +275,408 @@ TEST_F(ClubTest, EndOfDay_ProcessRemainingClients) {
     EXPECT_EQ(report[1], "2 100 09:15");
     EXPECT_EQ(report[2], "3 0 00:00");
 }
+
+// =========================
+// Test for client ids shared with the parser
+// =========================
+
+// 13. Events carry ids from a shared interning table, names are used only in the output
+TEST(ClubNamesTest, SharedNamesUseEventIds) {
+    Yadro::ClientNames names;
+    Club club(1, 9 * 60, 19 * 60, 10, &names);
+
+    EventData event = createEvent("10:00", 1, "alice");
+    event.clientId = names.intern("alice");
+    club.processEvent(event);
+    event = createEvent("10:05", 2, "alice", 1);
+    event.clientId = names.intern("alice");
+    club.processEvent(event);
+    // No id: the club interns the name into the shared table itself
+    club.processEvent(createEvent("10:10", 1, "bob"));
+    EXPECT_EQ(names.find("bob"), 1);
+    club.endOfDay();
+
+    const auto &outputs = club.getOutput();
+    ASSERT_EQ(outputs.size(), 5);
+    EXPECT_EQ(outputs[3], "19:00 11 alice");
+    EXPECT_EQ(outputs[4], "19:00 11 bob");
+}
+
+// =========================
+// Test for the waiting queue order
+// =========================
+
+// 14. A client leaving from the middle of the queue keeps the order of the others
+TEST_F(ClubTest, WaitingQueue_LeaveFromMiddle) {
+    for (int i = 1; i <= 3; i++) {
+        std::string client = "seated" + std::to_string(i);
+        club->processEvent(createEvent("10:00", 1, client));
+        club->processEvent(createEvent("10:00", 2, client, i));
+    }
+    for (const std::string client : {"w1", "w2", "w3"}) {
+        club->processEvent(createEvent("10:10", 1, client));
+        club->processEvent(createEvent("10:10", 3, client));
+    }
+    // w2 waits again: it keeps its place in the queue
+    club->processEvent(createEvent("10:15", 3, "w2"));
+    club->processEvent(createEvent("10:20", 4, "w1"));
+    club->processEvent(createEvent("10:30", 4, "seated2"));
+    club->processEvent(createEvent("10:40", 4, "seated3"));
+
+    const auto &outputs = club->getOutput();
+    std::vector<std::string> assignments;
+    for (const auto &line : outputs) {
+        if (line.find(" 12 ") != std::string::npos)
+            assignments.push_back(line);
+    }
+    std::vector<std::string> expected = {"10:30 12 w2 2", "10:40 12 w3 3"};
+    EXPECT_EQ(assignments, expected);
+}
+
+// =========================
+// Test for free table tracking
+// =========================
+
+// 15. Free tables across bitset words: count and lowest free index
+TEST(FreeTablesTest, CountAndLowest) {
+    Yadro::FreeTables tables(130);
+    EXPECT_EQ(tables.count(), 130);
+    EXPECT_EQ(tables.lowest(), 0);
+    for (int i = 0; i < 129; i++)
+        tables.markBusy(i);
+    EXPECT_TRUE(tables.any());
+    EXPECT_EQ(tables.lowest(), 129);
+    tables.markBusy(129);
+    EXPECT_FALSE(tables.any());
+    EXPECT_EQ(tables.lowest(), -1);
+    tables.markFree(70);
+    tables.markFree(70);
+    EXPECT_EQ(tables.count(), 1);
+    EXPECT_EQ(tables.lowest(), 70);
+}
+
+// =========================
+// Test for writing into an output sink
+// =========================
+
+// 16. Output and report written into a sink match getOutput() and getReport()
+TEST_F(ClubTest, WriteIntoMemorySink) {
+    club->processEvent(createEvent("09:30", 1, "client1"));
+    club->processEvent(createEvent("09:35", 2, "client1", 2));
+    club->processEvent(createEvent("09:50", 3, "client2"));
+    club->endOfDay();
+
+    Yadro::MemorySink sink;
+    club->writeOutput(sink);
+    EXPECT_EQ(sink.lines(), club->getOutput());
+    sink.clear();
+    club->writeReport(sink);
+    EXPECT_EQ(sink.lines(), club->getReport());
+    EXPECT_EQ(sink.data(), "1 0 00:00\n2 100 09:25\n3 0 00:00\n");
+}
+
+// =========================
+// Tests for typed output records
+// =========================
+
+// 17. Events are kept as typed records and rendered only when the output is read
+TEST_F(ClubTest, OutputRecords_Typed) {
+    club->processEvent(createEvent("08:50", 1, "client1"));
+    club->processEvent(createEvent("09:10", 1, "client1"));
+    club->processEvent(createEvent("09:15", 2, "client1", 3));
+
+    const auto &records = club->getRecords();
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[1].eventId, 13);
+    EXPECT_EQ(static_cast<Yadro::ClubError>(records[1].value), Yadro::ClubError::NotOpenYet);
+    EXPECT_EQ(records[3].eventId, 2);
+    EXPECT_EQ(records[3].value, 3);
+    EXPECT_EQ(club->getOutput().back(), "09:15 2 client1 3");
+}
+
+// 18. An echoed line that differs from its canonical form is printed as it was read
+TEST_F(ClubTest, OutputRecords_NonCanonicalLineKept) {
+    EventData event = createEvent("09:10", 1, "client1");
+    event.originalLine = "09:10  1\tclient1";
+    club->processEvent(event);
+    event = createEvent("09:15", 2, "client1", 2);
+    event.originalLine = "09:15 2 client1 02";
+    club->processEvent(event);
+
+    const auto &outputs = club->getOutput();
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_EQ(outputs[0], "09:10  1\tclient1");
+    EXPECT_EQ(outputs[1], "09:15 2 client1 02");
+    EXPECT_EQ(club->getRecords()[0].eventId, Yadro::OutputRecord::kRawLine);
+}
+
+// 19. Events parsed in place give the same output as owned events
+TEST_F(ClubTest, EventView_SameOutput) {
+    std::string input = "09:10 1 client1\n09:15  2 client1 2";
+    Yadro::EventView arrival{9 * 60 + 10, 1, -1, std::string_view(input).substr(8, 7), std::string_view(input).substr(0, 15)};
+    Yadro::EventView sit{9 * 60 + 15, 2, 2, std::string_view(input).substr(25, 7), std::string_view(input).substr(16)};
+    club->processEvent(arrival);
+    club->processEvent(sit);
+    club->processEvent(createEvent("09:20", 1, "client1"));
+
+    const auto &outputs = club->getOutput();
+    ASSERT_EQ(outputs.size(), 4);
+    EXPECT_EQ(outputs[0], "09:10 1 client1");
+    EXPECT_EQ(outputs[1], "09:15  2 client1 2");
+    EXPECT_EQ(outputs[3], "09:20 13 YouShallNotPass");
+    EXPECT_EQ(club->getTables()[1].occupied, true);
+}
+
+// 20. A club restored from a checkpoint goes on exactly like the original one
+TEST_F(ClubTest, Checkpoint_RestoreContinuesTheDay) {
+    // 3 tables busy, two clients waiting, one client in the club without a table
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:05", 2, "client1", 1));
+    club->processEvent(createEvent("09:10", 1, "client2"));
+    club->processEvent(createEvent("09:15", 2, "client2", 2));
+    club->processEvent(createEvent("09:20", 1, "client3"));
+    club->processEvent(createEvent("09:25", 2, "client3", 3));
+    club->processEvent(createEvent("09:30", 1, "client4"));
+    club->processEvent(createEvent("09:31", 3, "client4"));
+    club->processEvent(createEvent("09:40", 1, "client5"));
+    club->processEvent(createEvent("09:41", 3, "client5"));
+    club->processEvent(createEvent("09:50", 1, "client6"));
+    club->processEvent(createEvent("11:00", 4, "client1"));
+
+    std::string checkpoint;
+    club->saveCheckpoint(checkpoint);
+    Yadro::ClubConfig config;
+    ASSERT_TRUE(Club::checkpointConfig(checkpoint, config));
+    EXPECT_EQ(config.numTables, numTables);
+
+    // The restored club shares a names table that already has other ids.
+    Yadro::ClientNames names;
+    names.intern("someone");
+    names.intern("client5");
+    Club restored(numTables, openTime, closeTime, hourlyCost, &names);
+    ASSERT_TRUE(restored.restoreCheckpoint(checkpoint));
+    EXPECT_EQ(restored.eventsProcessed(), club->eventsProcessed());
+
+    size_t written = club->getRecords().size();
+    for (Club *day : {club, &restored}) {
+        day->processEvent(createEvent("12:00", 4, "client2"));
+        day->processEvent(createEvent("12:30", 2, "client6", 1));
+        day->processEvent(createEvent("13:00", 1, "client3"));
+        day->endOfDay();
+    }
+    Yadro::MemorySink expected, actual;
+    club->writeOutput(expected, written);
+    club->writeReport(expected);
+    restored.writeOutput(actual);
+    restored.writeReport(actual);
+    EXPECT_EQ(actual.data(), expected.data());
+    EXPECT_NE(actual.data().find("12:00 12 client5 2"), std::string_view::npos);
+}
+
+// 21. Damaged checkpoints and checkpoints of another club are rejected
+TEST_F(ClubTest, Checkpoint_RejectsBadData) {
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:05", 2, "client1", 1));
+    std::string checkpoint;
+    club->saveCheckpoint(checkpoint);
+
+    Club other(numTables + 1, openTime, closeTime, hourlyCost);
+    EXPECT_FALSE(other.restoreCheckpoint(checkpoint));
+    Club same(numTables, openTime, closeTime, hourlyCost);
+    EXPECT_FALSE(same.restoreCheckpoint(checkpoint.substr(0, checkpoint.size() - 1)));
+    EXPECT_FALSE(same.restoreCheckpoint(checkpoint + "x"));
+    std::string badVersion = checkpoint;
+    badVersion[4] = 9;
+    EXPECT_FALSE(same.restoreCheckpoint(badVersion));
+    EXPECT_TRUE(same.restoreCheckpoint(checkpoint));
+    EXPECT_TRUE(same.getTables()[0].occupied);
+}
+
+// 22. Statistics count events, errors, peaks and table turnovers
+TEST_F(ClubTest, Stats_CountersAndPeaks) {
+    Yadro::RunStats stats;
+    club->setStats(&stats);
+    club->processEvent(createEvent("08:50", 1, "client1"));      // NotOpenYet
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:01", 2, "client1", 1));
+    club->processEvent(createEvent("09:02", 1, "client2"));
+    club->processEvent(createEvent("09:03", 2, "client2", 1));   // PlaceIsBusy
+    club->processEvent(createEvent("09:04", 2, "client2", 2));
+    club->processEvent(createEvent("09:05", 1, "client3"));
+    club->processEvent(createEvent("09:06", 2, "client3", 3));
+    club->processEvent(createEvent("09:07", 1, "client4"));
+    club->processEvent(createEvent("09:08", 3, "client4"));
+    club->processEvent(createEvent("10:00", 4, "client1"));      // client4 takes table 1
+    club->processEvent(createEvent("10:01", 4, "client5"));      // ClientUnknown
+    club->endOfDay();
+
+    EXPECT_EQ(stats.eventsById[1], 5);
+    EXPECT_EQ(stats.eventsById[2], 4);
+    EXPECT_EQ(stats.eventsById[3], 1);
+    EXPECT_EQ(stats.eventsById[4], 2);
+    EXPECT_EQ(stats.errors[static_cast<size_t>(Yadro::ClubError::NotOpenYet)], 1);
+    EXPECT_EQ(stats.errors[static_cast<size_t>(Yadro::ClubError::PlaceIsBusy)], 1);
+    EXPECT_EQ(stats.errors[static_cast<size_t>(Yadro::ClubError::ClientUnknown)], 1);
+    EXPECT_EQ(stats.peakQueue, 1);
+    EXPECT_EQ(stats.peakClients, 4);
+    EXPECT_EQ(stats.clientsInClub, 3);
+    EXPECT_EQ(stats.seatedFromQueue, 1);
+    EXPECT_EQ(stats.tableTurnovers, 4);
+    EXPECT_EQ(stats.clientsSentAway, 3);
+}
+
+// 23. Tables taken and clients seated at a minute, with sessions still open and after the day
+TEST_F(ClubTest, Sessions_PointQueries) {
+    club->recordSessions();
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:10", 2, "client1", 1));
+    club->processEvent(createEvent("09:20", 1, "client2"));
+    club->processEvent(createEvent("09:30", 2, "client2", 2));
+    club->processEvent(createEvent("09:40", 2, "client1", 3));   // client1 moves to table 3
+
+    // The day is still going: client2 and client1 are at their tables.
+    EXPECT_EQ(club->sessions().busyTablesAt(FromString("09:45").value()), 2);
+    EXPECT_EQ(club->sessions().busyTablesAt(FromString("20:00").value()), 2);
+
+    club->processEvent(createEvent("10:00", 4, "client2"));
+    club->endOfDay();
+
+    const Yadro::SessionIndex &sessions = club->sessions();
+    EXPECT_EQ(sessions.size(), 3u);
+    auto at = [&](int table, const char *time) {
+        Yadro::ClientId client = sessions.clientAt(table, FromString(time).value());
+        return client == Yadro::kNoClient ? std::string("free") : std::string(club->clientName(client));
+    };
+    EXPECT_EQ(at(1, "09:10"), "client1");
+    EXPECT_EQ(at(1, "09:39"), "client1");
+    EXPECT_EQ(at(1, "09:40"), "free");
+    EXPECT_EQ(at(3, "09:40"), "client1");
+    EXPECT_EQ(at(2, "09:29"), "free");
+    EXPECT_EQ(at(2, "10:00"), "free");
+    EXPECT_EQ(at(3, "18:59"), "client1");
+    EXPECT_EQ(at(3, "19:00"), "free");
+    EXPECT_EQ(at(4, "12:00"), "free");
+
+    EXPECT_EQ(sessions.busyTablesAt(FromString("09:05").value()), 0);
+    EXPECT_EQ(sessions.busyTablesAt(FromString("09:35").value()), 2);
+    EXPECT_EQ(sessions.busyTablesAt(FromString("09:40").value()), 2);
+    EXPECT_EQ(sessions.busyTablesAt(FromString("10:00").value()), 1);
+    EXPECT_EQ(sessions.busyTablesAt(FromString("19:00").value()), 0);
+}
+
+// 24. Sessions sharing a minute with a range, in the order they started
+TEST_F(ClubTest, Sessions_Overlapping) {
+    club->recordSessions();
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:00", 2, "client1", 1));
+    club->processEvent(createEvent("09:00", 1, "client2"));
+    club->processEvent(createEvent("09:00", 2, "client2", 2));
+    club->processEvent(createEvent("09:00", 1, "client3"));
+    club->processEvent(createEvent("09:00", 2, "client3", 3));
+    club->processEvent(createEvent("09:05", 1, "client4"));
+    club->processEvent(createEvent("09:05", 3, "client4"));
+    club->processEvent(createEvent("10:00", 4, "client1"));      // client4 takes table 1
+    club->processEvent(createEvent("11:00", 4, "client2"));
+    club->processEvent(createEvent("12:00", 4, "client4"));
+    club->endOfDay();
+
+    auto overlapping = [&](const char *from, const char *to) {
+        std::vector<std::string> found;
+        for (const auto &session : club->sessions().overlapping(FromString(from).value(), FromString(to).value()))
+            found.push_back(std::to_string(session.table) + " " + std::string(club->clientName(session.client)) + " "
+                            + ToString(session.start) + " " + ToString(session.end));
+        return found;
+    };
+    EXPECT_EQ(overlapping("08:00", "08:59"), std::vector<std::string>{});
+    EXPECT_EQ(overlapping("10:00", "10:00"),
+              (std::vector<std::string>{"2 client2 09:00 11:00", "3 client3 09:00 19:00", "1 client4 10:00 12:00"}));
+    EXPECT_EQ(overlapping("11:00", "11:59"),
+              (std::vector<std::string>{"3 client3 09:00 19:00", "1 client4 10:00 12:00"}));
+    EXPECT_EQ(overlapping("18:00", "23:00"), std::vector<std::string>{"3 client3 09:00 19:00"});
+    EXPECT_EQ(overlapping("09:00", "23:59").size(), 4u);
+}
+
+// 25. Utilization buckets of each table add up to its line of the day report
+TEST_F(ClubTest, Utilization_BucketsAddUpToTheReport) {
+    club->recordSessions();
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:10", 2, "client1", 1));
+    club->processEvent(createEvent("09:20", 1, "client2"));
+    club->processEvent(createEvent("09:30", 2, "client2", 2));
+    club->processEvent(createEvent("11:15", 2, "client1", 3));   // client1 moves to table 3
+    club->processEvent(createEvent("12:00", 4, "client2"));
+    club->endOfDay();
+
+    Yadro::ClubConfig config{openTime, closeTime, numTables, hourlyCost};
+    Yadro::MemorySink sink;
+    Yadro::writeUtilization(club->recordedSessions(), config, 120, sink);
+    std::vector<std::string> lines = sink.lines();
+    ASSERT_EQ(lines.size(), 20u);   // 5 buckets for each of 3 tables and the total
+    EXPECT_EQ(lines[0], "1 09:00 0 01:50");
+    EXPECT_EQ(lines[1], "1 11:00 30 00:15");
+    EXPECT_EQ(lines[5], "2 09:00 0 01:30");
+    EXPECT_EQ(lines[6], "2 11:00 30 01:00");
+    EXPECT_EQ(lines[10], "3 09:00 0 00:00");
+    EXPECT_EQ(lines[11], "3 11:00 0 01:45");
+    EXPECT_EQ(lines[12], "3 13:00 0 02:00");
+    EXPECT_EQ(lines[14], "3 17:00 80 02:00");
+    EXPECT_EQ(lines[15], "total 09:00 0 03:20");
+    EXPECT_EQ(lines[16], "total 11:00 60 03:00");
+
+    // Every table adds up to its line of the day report.
+    std::vector<std::string> report = club->getReport();
+    for (int table = 0; table < numTables; table++) {
+        int revenue = 0;
+        int occupied = 0;
+        for (int bucket = 0; bucket < 5; bucket++) {
+            auto tokens = Yadro::Util::splitString(lines[table * 5 + bucket]);
+            revenue += Yadro::Util::FromString(tokens[2]).value();
+            occupied += FromString(tokens[3]).value();
+        }
+        EXPECT_EQ(std::to_string(table + 1) + " " + std::to_string(revenue) + " " + ToString(occupied), report[table]);
+    }
+}
+
+// 26. The last bucket is cut at the close time
+TEST_F(ClubTest, Utilization_ShortLastBucket) {
+    club->recordSessions();
+    club->processEvent(createEvent("09:00", 1, "client1"));
+    club->processEvent(createEvent("09:00", 2, "client1", 1));
+    club->endOfDay();
+
+    Yadro::ClubConfig config{openTime, closeTime, numTables, hourlyCost};
+    Yadro::MemorySink sink;
+    Yadro::writeUtilization(club->recordedSessions(), config, 45, sink);
+    std::vector<std::string> lines = sink.lines();
+    ASSERT_EQ(lines.size(), 4u * 14);   // 10 hours in 13 buckets of 45 minutes and one of 15
+    EXPECT_EQ(lines[12], "1 18:00 0 00:45");
+    EXPECT_EQ(lines[13], "1 18:45 100 00:15");
+    EXPECT_EQ(lines[14 * 3 + 13], "total 18:45 100 00:15");
+}
+
+// 27. Output modes keep only the records they print; the report and summary stay the same
+TEST_F(ClubTest, OutputModes_KeepOnlyWhatIsPrinted) {
+    auto playDay = [&](Yadro::OutputMode mode) {
+        Club day(numTables, openTime, closeTime, hourlyCost);
+        day.setOutputMode(mode);
+        day.processEvent(createEvent("08:50", 1, "client1"));      // NotOpenYet
+        day.processEvent(createEvent("09:00", 1, "client1"));
+        day.processEvent(createEvent("09:01", 2, "client1", 1));
+        day.processEvent(createEvent("09:02", 1, "client2"));
+        day.processEvent(createEvent("09:03", 2, "client2", 1));   // PlaceIsBusy
+        day.processEvent(createEvent("10:30", 4, "client1"));
+        day.endOfDay();
+        Yadro::MemorySink output, report, summary;
+        day.writeOutput(output);
+        day.writeReport(report);
+        day.writeSummary(summary);
+        EXPECT_EQ(report.data(), "1 20 01:29\n2 0 00:00\n3 0 00:00\n");
+        EXPECT_EQ(summary.data(), "total 20 01:29\n");
+        return std::make_pair(day.getRecords().size(), std::string(output.data()));
+    };
+    EXPECT_EQ(playDay(Yadro::OutputMode::Full).first, 9u);   // with the event 11 of client2 at the close
+    EXPECT_EQ(playDay(Yadro::OutputMode::ErrorsOnly),
+              std::make_pair(size_t(2), std::string("08:50 13 NotOpenYet\n09:03 13 PlaceIsBusy\n")));
+    EXPECT_EQ(playDay(Yadro::OutputMode::ReportOnly), std::make_pair(size_t(0), std::string()));
+    EXPECT_EQ(playDay(Yadro::OutputMode::Summary), std::make_pair(size_t(0), std::string()));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "../../project/EventLog.hpp"
+#include "../../project/Runner.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using Yadro::MemorySink;
+
+// Helper function to write content to a temporary file.
+bool writeToFile(const std::string &filename, const std::string &content) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs)
+        return false;
+    ofs << content;
+    return true;
+}
+
+static const std::string textFileName = "temp_eventlog_test.txt";
+static const std::string logFileName = "temp_eventlog_test.log";
+
+// Convert content into a binary log, return the log bytes.
+static std::string convertText(const std::string &content, bool &converted, std::string &errorLine) {
+    EXPECT_TRUE(writeToFile(textFileName, content));
+    MemorySink log;
+    converted = Yadro::EventLog::convert(textFileName, log, errorLine);
+    std::remove(textFileName.c_str());
+    return std::string(log.data());
+}
+
+static std::string replayLog(const std::string &log, bool &replayed) {
+    EXPECT_TRUE(writeToFile(logFileName, log));
+    MemorySink out;
+    std::string error;
+    replayed = Yadro::EventLog::replay(logFileName, out, error);
+    EXPECT_EQ(error.empty(), replayed);
+    std::remove(logFileName.c_str());
+    return std::string(out.data());
+}
+
+TEST(EventLogTest, ReplayGivesTheFileModeOutput) {
+    std::string content = "3\r\n09:00 19:00\n10\n"
+        "08:48 1 client1\n"
+        "09:41 1 client1\n"
+        "09:48 1 client2\n"
+        "\n"
+        "09:52 3  client1\n"
+        "09:54 2 client1 1\n"
+        "10:25 2 client2 +2\n"
+        "10:58 1 client3\n"
+        "10:59 2 client3 3\n"
+        "11:30 1 client4\n"
+        "11:35 2 client4 2\n"
+        "11:45 3 client4\n"
+        "12:33 4 client1\n"
+        "12:43 4 client2\n"
+        "15:52 4 client4";
+    ASSERT_TRUE(writeToFile(textFileName, content));
+    MemorySink expected;
+    EXPECT_TRUE(Yadro::runClubFile(textFileName, expected));
+
+    bool converted = false, replayed = false;
+    std::string errorLine;
+    std::string log = convertText(content, converted, errorLine);
+    ASSERT_TRUE(converted);
+    EXPECT_LT(log.size(), content.size());
+    EXPECT_EQ(replayLog(log, replayed), expected.data());
+    EXPECT_TRUE(replayed);
+}
+
+TEST(EventLogTest, BadTextIsNotConverted) {
+    bool converted = true;
+    std::string errorLine;
+    convertText("3\n09:00 19:00\n10\n08:48 1 client1\n09:00 5 client1\n", converted, errorLine);
+    EXPECT_FALSE(converted);
+    EXPECT_EQ(errorLine, "09:00 5 client1");
+
+    convertText("3\n09:00 19:00\n", converted, errorLine);
+    EXPECT_FALSE(converted);
+    EXPECT_EQ(errorLine.substr(0, 40), "Not enough configuration lines provided.");
+}
+
+TEST(EventLogTest, DamagedLogIsRejected) {
+    bool converted = false, replayed = true;
+    std::string errorLine;
+    std::string log = convertText("2\n09:00 19:00\n10\n09:10 1 a\n09:20 2 a 2\n09:30 4 a\n", converted, errorLine);
+    ASSERT_TRUE(converted);
+    replayLog(log, replayed);
+    EXPECT_TRUE(replayed);
+
+    replayLog(log.substr(0, log.size() - 2), replayed);
+    EXPECT_FALSE(replayed);
+    replayLog("XEVL" + log.substr(4), replayed);
+    EXPECT_FALSE(replayed);
+    // The table number of the second record is out of range.
+    std::string badTable = log;
+    size_t table = badTable.find(std::string("\x02\xB0\x04\x00\x02\n", 6));
+    ASSERT_NE(table, std::string::npos);
+    badTable[table + 4] = 3;
+    replayLog(badTable, replayed);
+    EXPECT_FALSE(replayed);
+    // Values that would wrap into valid ones when cast to int: 2^32 + 2 tables and
+    // an event at 2^32 + 09:20.
+    std::string wideTables = log.substr(0, 5) + std::string("\x82\x80\x80\x80\x10", 5) + log.substr(6);
+    replayLog(wideTables, replayed);
+    EXPECT_FALSE(replayed);
+    std::string wideTime = log;
+    wideTime.replace(table + 1, 2, std::string("\xB0\x84\x80\x80\x10", 5));
+    replayLog(wideTime, replayed);
+    EXPECT_FALSE(replayed);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "../../project/Library.hpp"
+#include "../../project/yadro.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+std::string readFile(const std::string &filename) {
+    std::ifstream ifs(filename);
+    std::ostringstream content;
+    content << ifs.rdbuf();
+    return content.str();
+}
+
+const char *kTestNames[] = {"test1", "test2", "test3", "test4", "test5"};
+
+// ******************
+// Tests for C++ API
+// ******************
+
+TEST(LibraryTest, RunDayMatchesMain) {
+    for (const char *name : kTestNames) {
+        std::string input = readFile(std::string("../../tests/inputs/") + name + ".in.txt");
+        std::string expected = readFile(std::string("../../tests/outputs/") + name + ".out.txt");
+        ASSERT_FALSE(input.empty()) << name;
+        Yadro::DayResult result = Yadro::runDay(input);
+        EXPECT_EQ(result.text, expected) << name;
+        EXPECT_EQ(result.accepted, result.errorLine.empty()) << name;
+    }
+}
+
+TEST(LibraryTest, StreamMatchesRunDay) {
+    for (const char *name : kTestNames) {
+        std::string input = readFile(std::string("../../tests/inputs/") + name + ".in.txt");
+        std::string expected = Yadro::runDay(input).text;
+        for (size_t piece : {size_t(1), size_t(7), input.size()}) {
+            Yadro::DayStream stream;
+            for (size_t offset = 0; offset < input.size(); offset += piece)
+                stream.feed(std::string_view(input).substr(offset, piece));
+            EXPECT_EQ(stream.finish().text, expected) << name << " " << piece;
+        }
+    }
+}
+
+TEST(LibraryTest, StructuredResult) {
+    std::string input = "2\n09:00 19:00\n10\n08:50 1 a\n09:10  1 a\n09:20 2 a 1\n09:30 1 b\n09:31 2 b 1\n11:00 4 a\n";
+    Yadro::DayResult result = Yadro::runDay(input);
+    ASSERT_TRUE(result.accepted);
+    EXPECT_EQ(result.config.numTables, 2);
+    EXPECT_EQ(result.config.hourlyCost, 10);
+    ASSERT_EQ(result.events.size(), 9u);
+    EXPECT_EQ(result.events[0].eventId, 1);
+    EXPECT_EQ(result.events[1].eventId, 13);
+    EXPECT_EQ(result.events[1].error, "NotOpenYet");
+    EXPECT_TRUE(result.events[1].client.empty());
+    // The line with two spaces is echoed as written but still read into fields.
+    EXPECT_EQ(result.events[2].time, 9 * 60 + 10);
+    EXPECT_EQ(result.events[2].client, "a");
+    EXPECT_EQ(result.events[3].table, 1);
+    EXPECT_EQ(result.events[6].error, "PlaceIsBusy");
+    // b leaves at the close.
+    EXPECT_EQ(result.events[8].eventId, 11);
+    EXPECT_EQ(result.events[8].client, "b");
+    EXPECT_EQ(result.events[8].time, 19 * 60);
+    ASSERT_EQ(result.tables.size(), 2u);
+    EXPECT_EQ(result.tables[0].revenue, 20);
+    EXPECT_EQ(result.tables[0].occupied, 100);
+    EXPECT_EQ(result.tables[1].revenue, 0);
+
+    Yadro::DayResult summary = Yadro::runDay(input, Yadro::OutputMode::Summary);
+    EXPECT_EQ(summary.text, "total 20 01:40\n");
+    EXPECT_TRUE(summary.events.empty());
+}
+
+TEST(LibraryTest, RejectedInput) {
+    Yadro::DayResult result = Yadro::runDay("2\n09:00 19:00\n10\n08:50 1 a\nbad line\n09:00 1 b\n");
+    EXPECT_FALSE(result.accepted);
+    EXPECT_EQ(result.errorLine, "bad line");
+    EXPECT_EQ(result.text, "bad line\n");
+
+    Yadro::DayStream stream;
+    EXPECT_TRUE(stream.feed("2\n09:00"));
+    EXPECT_FALSE(stream.feed(" 08:00\n10\n"));
+    EXPECT_FALSE(stream.feed("09:00 1 b\n"));
+    EXPECT_EQ(stream.finish().errorLine, "09:00 08:00");
+
+    Yadro::DayStream empty;
+    EXPECT_FALSE(empty.finish().accepted);
+}
+
+// ****************
+// Tests for C ABI
+// ****************
+
+TEST(LibraryTest, CInterface) {
+    EXPECT_EQ(yadro_api_version(), YADRO_API_VERSION);
+    std::string input = readFile("../../tests/inputs/test1.in.txt");
+    yadro_day *day = yadro_run(input.data(), input.size(), YADRO_OUTPUT_FULL);
+    ASSERT_NE(day, nullptr);
+    EXPECT_EQ(yadro_accepted(day), 1);
+    EXPECT_STREQ(yadro_error_line(day), "");
+    size_t size = 0;
+    const char *output = yadro_output(day, &size);
+    EXPECT_EQ(std::string(output, size), readFile("../../tests/outputs/test1.out.txt"));
+
+    yadro_event event;
+    ASSERT_EQ(yadro_event_at(day, 0, &event), 1);
+    EXPECT_EQ(event.time, 8 * 60 + 48);
+    EXPECT_EQ(event.event_id, 1);
+    EXPECT_STREQ(event.client, "client1");
+    EXPECT_EQ(yadro_event_at(day, yadro_event_count(day), &event), 0);
+    yadro_table table;
+    ASSERT_EQ(yadro_table_count(day), 3u);
+    ASSERT_EQ(yadro_table_at(day, 0, &table), 1);
+    EXPECT_EQ(table.number, 1);
+    EXPECT_EQ(yadro_table_at(day, 3, &table), 0);
+    yadro_free(day);
+
+    yadro_day *stream = yadro_stream_open(YADRO_OUTPUT_SUMMARY);
+    ASSERT_NE(stream, nullptr);
+    EXPECT_EQ(yadro_accepted(stream), 0);
+    for (char c : input)
+        ASSERT_EQ(yadro_stream_feed(stream, &c, 1), 1);
+    yadro_stream_finish(stream);
+    EXPECT_EQ(yadro_stream_feed(stream, "x", 1), 0);
+    EXPECT_EQ(yadro_accepted(stream), 1);
+    EXPECT_EQ(yadro_event_count(stream), 0u);
+    EXPECT_STREQ(yadro_output(stream, nullptr), Yadro::runDay(input, Yadro::OutputMode::Summary).text.c_str());
+    yadro_free(stream);
+
+    EXPECT_EQ(yadro_run(input.data(), input.size(), 42), nullptr);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../../project/Parser.hpp"
+#include "../../project/ThreadPool.hpp"
 #include <fstream>
 #include <cstdio>
 #include <string>
@@ -7,6 +8,8 @@
 using Yadro::Parser;
 using Yadro::ClubConfig;
 using Yadro::EventData;
+using Yadro::EventView;
+using Yadro::ThreadPool;
 
 // Helper function to write content to a temporary file.
 bool writeToFile(const std::string &filename, const std::string &content) {
@@ -385,3 +388,199 @@ TEST(ParserErrorTest, ValidFile) {
     EXPECT_EQ(events.size(), 5);
     removeTempFile();
 }
+
+// *************************
+// Tests for streaming mode
+// *************************
+
+TEST(ParserStreamTest, ValidFile) {
+    std::string content = validConfig +
+        "08:48 1 client1\n"
+        "\n"
+        "10:00 2 client1 1\n";
+    ASSERT_TRUE(writeToFile(tempFileName, content));
+
+    Parser parser(tempFileName);
+    ClubConfig config;
+    std::string errorLine;
+    ASSERT_TRUE(parser.ReadConfig(config, errorLine));
+    EXPECT_EQ(config.numTables, 3);
+    EXPECT_EQ(config.hourlyCost, 10);
+
+    EventData event;
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.originalLine, "08:48 1 client1");
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.originalLine, "10:00 2 client1 1");
+    EXPECT_EQ(event.TableNumber, 1);
+    EXPECT_FALSE(parser.NextEvent(event, errorLine));
+    EXPECT_FALSE(parser.Failed());
+    removeTempFile();
+}
+
+TEST(ParserStreamTest, StopsAtFirstBadLine) {
+    std::string content = validConfig +
+        "08:48 1 client1\n"
+        "09:00 5 client1\n"
+        "09:10 7 client2\n";
+    ASSERT_TRUE(writeToFile(tempFileName, content));
+
+    Parser parser(tempFileName);
+    ClubConfig config;
+    std::string errorLine;
+    ASSERT_TRUE(parser.ReadConfig(config, errorLine));
+    EventData event;
+    EXPECT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_FALSE(parser.NextEvent(event, errorLine));
+    EXPECT_TRUE(parser.Failed());
+    EXPECT_EQ(errorLine, "09:00 5 client1");
+    EXPECT_FALSE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(errorLine, "09:00 5 client1");
+    removeTempFile();
+}
+
+TEST(ParserStreamTest, EventViewsIntoTheFile) {
+    std::string content = validConfig +
+        "08:48 1 client1\r\n"
+        "\n"
+        "10:00 2 client1 1\n"
+        "10:05 9 client1\n";
+    ASSERT_TRUE(writeToFile(tempFileName, content));
+
+    Parser parser(tempFileName);
+    ClubConfig config;
+    std::string errorLine;
+    Yadro::EventView event;
+    EXPECT_FALSE(parser.NextEvent(event, errorLine));   // config lines not read yet
+    ASSERT_TRUE(parser.ReadConfig(config, errorLine));
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.line, "08:48 1 client1");
+    EXPECT_EQ(event.clientName, "client1");
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.line, "10:00 2 client1 1");
+    EXPECT_EQ(event.tableNumber, 1);
+    EXPECT_FALSE(parser.NextEvent(event, errorLine));
+    EXPECT_TRUE(parser.Failed());
+    EXPECT_EQ(errorLine, "10:05 9 client1");
+    removeTempFile();
+}
+
+TEST(ParserStreamTest, InsufficientConfigLines) {
+    std::string content = "abc\n09:00 19:00";
+    ASSERT_TRUE(writeToFile(tempFileName, content));
+
+    Parser parser(tempFileName);
+    ClubConfig config;
+    std::string errorLine;
+    EXPECT_FALSE(parser.ReadConfig(config, errorLine));
+    EXPECT_TRUE(parser.Failed());
+    EXPECT_EQ(errorLine, "Not enough configuration lines provided.\nMust be:\n<Number of Tables>\n<Opening Hours> <Closing Hours>\n<Hourly Cost>.");
+    removeTempFile();
+}
+
+TEST(ParserStreamTest, CrLfAndExtraSpaces) {
+    std::string content = "3\r\n09:00 19:00\r\n10\r\n08:48  1\tclient1\r\n10:00 2 client1 1";
+    ASSERT_TRUE(writeToFile(tempFileName, content));
+
+    Parser parser(tempFileName);
+    ClubConfig config;
+    std::string errorLine;
+    ASSERT_TRUE(parser.ReadConfig(config, errorLine));
+    EventData event;
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.originalLine, "08:48  1\tclient1");
+    EXPECT_EQ(event.ClientName, "client1");
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.originalLine, "10:00 2 client1 1");
+    EXPECT_FALSE(parser.NextEvent(event, errorLine));
+    EXPECT_FALSE(parser.Failed());
+    removeTempFile();
+}
+
+TEST(ParserStreamTest, InternsClientNames) {
+    std::string content = validConfig +
+        "08:48 1 client1\n"
+        "09:00 1 client2\n"
+        "10:00 2 client1 1\n";
+    ASSERT_TRUE(writeToFile(tempFileName, content));
+
+    Parser parser(tempFileName);
+    ClubConfig config;
+    std::string errorLine;
+    ASSERT_TRUE(parser.ReadConfig(config, errorLine));
+    EventData event;
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.clientId, 0);
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.clientId, 1);
+    ASSERT_TRUE(parser.NextEvent(event, errorLine));
+    EXPECT_EQ(event.clientId, 0);
+    EXPECT_EQ(parser.names().size(), 2);
+    EXPECT_EQ(parser.names().name(1), "client2");
+    removeTempFile();
+}
+
+// *************************
+// Tests for parallel chunked parsing
+// *************************
+
+// Parse the events of content in chunks of chunkSize bytes and collect the lines seen.
+static bool parseInChunks(const std::string &content, size_t chunkSize, std::vector<std::string> &lines,
+                          std::string &errorLine, size_t *chunks = nullptr) {
+    if (!writeToFile(tempFileName, content))
+        return false;
+    Parser parser(tempFileName);
+    ClubConfig config;
+    bool ok = parser.ReadConfig(config, errorLine);
+    ThreadPool pool(3);
+    ok = ok && parser.ParseChunks(pool, [&](const std::vector<EventView> &events) {
+        if (chunks != nullptr)
+            (*chunks)++;
+        for (const auto &event : events)
+            lines.emplace_back(event.line);
+    }, errorLine, chunkSize);
+    EXPECT_EQ(parser.Failed(), !ok);
+    removeTempFile();
+    return ok;
+}
+
+TEST(ParserChunkTest, SameEventsInFileOrder) {
+    std::string content = validConfig;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 200; i++) {
+        expected.push_back("09:" + std::to_string(10 + i % 50) + " 1 client" + std::to_string(i));
+        content += expected.back() + "\n";
+    }
+    std::vector<std::string> lines;
+    std::string errorLine;
+    size_t chunks = 0;
+    ASSERT_TRUE(parseInChunks(content, 64, lines, errorLine, &chunks));
+    EXPECT_EQ(lines, expected);
+    EXPECT_GT(chunks, 10);
+}
+
+TEST(ParserChunkTest, CrLfEmptyLinesAndNoFinalNewline) {
+    std::string content = "3\r\n09:00 19:00\r\n10\r\n08:48  1\tclient1\r\n\r\n\n10:00 2 client1 1";
+    std::vector<std::string> lines;
+    std::string errorLine;
+    ASSERT_TRUE(parseInChunks(content, 5, lines, errorLine));
+    EXPECT_EQ(lines, (std::vector<std::string>{"08:48  1\tclient1", "10:00 2 client1 1"}));
+}
+
+TEST(ParserChunkTest, ReportsLowestBadLine) {
+    std::string content = validConfig;
+    for (int i = 0; i < 100; i++) {
+        if (i == 37 || i == 38 || i == 90)
+            content += "10:00 5 bad" + std::to_string(i) + "\n";
+        else
+            content += "10:00 1 client" + std::to_string(i) + "\n";
+    }
+    // Whatever the chunk size, the first bad line of the file is reported.
+    for (size_t chunkSize : {1, 40, 100, 1000, 1 << 20}) {
+        std::vector<std::string> lines;
+        std::string errorLine;
+        EXPECT_FALSE(parseInChunks(content, chunkSize, lines, errorLine));
+        EXPECT_EQ(errorLine, "10:00 5 bad37");
+        EXPECT_LE(lines.size(), 37);
+    }
+}
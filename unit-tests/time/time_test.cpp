@@ -96,6 +96,17 @@ TEST(FormatTimeTest, FormatBoundary) {
     EXPECT_EQ(formatted, "23:59");
 }
 
+TEST(FormatTimeTest, FormatMoreThan99Hours) {
+    std::string formatted = ToString(100 * 60 + 5);
+    EXPECT_EQ(formatted, "100:05");
+}
+
+TEST(FormatTimeTest, FormatIntoBuffer) {
+    char text[Yadro::Time::kMaxLength];
+    size_t length = Yadro::Time::Format(7 * 60 + 3, text);
+    EXPECT_EQ(std::string(text, length), "07:03");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();